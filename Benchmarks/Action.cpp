@@ -0,0 +1,118 @@
+//
+// Benchmarks for the game actions
+//
+
+#include "fixtures.h"
+#include "Action.h"
+
+static void shotExecuteAll(benchmark::State &state, fixtures::EnvFactory createEnv) {
+    auto env = createEnv();
+    auto actor = env->team1->chasers[0];
+    env->quaffle->position = actor->position;
+    gameController::Shot shot(env, actor, env->quaffle, {14, 6});
+    fixtures::AllocationCounter counter(state);
+    for(auto _ : state){
+        benchmark::DoNotOptimize(shot.executeAll());
+    }
+}
+BENCHMARK_CAPTURE(shotExecuteAll, setup, &fixtures::createSetupEnv);
+BENCHMARK_CAPTURE(shotExecuteAll, crowded, &fixtures::createCrowdedEnv);
+
+static void shotExecuteAllFiltered(benchmark::State &state) {
+    auto env = fixtures::createSetupEnv();
+    auto actor = env->team1->chasers[0];
+    env->quaffle->position = actor->position;
+    gameController::Shot shot(env, actor, env->quaffle, {14, 6});
+    gameController::OutcomeFilter filter;
+    filter.minProbability = 0.05;
+    fixtures::AllocationCounter counter(state);
+    for(auto _ : state){
+        benchmark::DoNotOptimize(shot.executeAll(filter));
+    }
+}
+BENCHMARK(shotExecuteAllFiltered);
+
+static void shotExecuteAllShared(benchmark::State &state, fixtures::EnvFactory createEnv) {
+    auto env = createEnv();
+    auto actor = env->team1->chasers[0];
+    env->quaffle->position = actor->position;
+    gameController::Shot shot(env, actor, env->quaffle, {14, 6});
+    fixtures::AllocationCounter counter(state);
+    for(auto _ : state){
+        benchmark::DoNotOptimize(shot.executeAllShared());
+    }
+}
+BENCHMARK_CAPTURE(shotExecuteAllShared, setup, &fixtures::createSetupEnv);
+BENCHMARK_CAPTURE(shotExecuteAllShared, crowded, &fixtures::createCrowdedEnv);
+
+static void shotSuccessProb(benchmark::State &state, fixtures::EnvFactory createEnv) {
+    auto env = createEnv();
+    auto actor = env->team1->chasers[0];
+    env->quaffle->position = actor->position;
+    std::vector<gameController::Shot> shots;
+    for(int x = 0; x < gameModel::FIELD_WIDTH; x++){
+        for(int y = 0; y < gameModel::FIELD_HEIGHT; y++){
+            shots.emplace_back(env, actor, env->quaffle, gameModel::Position{x, y});
+        }
+    }
+
+    fixtures::AllocationCounter counter(state);
+    for(auto _ : state){
+        for(const auto &shot : shots){
+            benchmark::DoNotOptimize(shot.successProb());
+        }
+    }
+}
+BENCHMARK_CAPTURE(shotSuccessProb, setup, &fixtures::createSetupEnv);
+BENCHMARK_CAPTURE(shotSuccessProb, crowded, &fixtures::createCrowdedEnv);
+
+static void shotGetOutcomes(benchmark::State &state, fixtures::EnvFactory createEnv) {
+    auto env = createEnv();
+    auto actor = env->team1->chasers[0];
+    env->quaffle->position = actor->position;
+    gameController::Shot shot(env, actor, env->quaffle, {14, 6});
+    fixtures::AllocationCounter counter(state);
+    for(auto _ : state){
+        benchmark::DoNotOptimize(shot.getOutcomes());
+    }
+}
+BENCHMARK_CAPTURE(shotGetOutcomes, setup, &fixtures::createSetupEnv);
+BENCHMARK_CAPTURE(shotGetOutcomes, crowded, &fixtures::createCrowdedEnv);
+
+static void bludgerShotExecuteAll(benchmark::State &state) {
+    auto env = fixtures::createCrowdedEnv();
+    auto actor = env->team1->beaters[0];
+    gameController::Shot shot(env, actor, env->bludgers[0], env->team1->chasers[0]->position);
+    fixtures::AllocationCounter counter(state);
+    for(auto _ : state){
+        benchmark::DoNotOptimize(shot.executeAll());
+    }
+}
+BENCHMARK(bludgerShotExecuteAll);
+
+static void moveExecuteAll(benchmark::State &state) {
+    // ramming an opponent holding the quaffle: displaced player, quaffle scatter and foul branches
+    auto env = fixtures::createCrowdedEnv();
+    gameController::Move move(env, env->team2->chasers[0], env->team1->chasers[0]->position);
+    fixtures::AllocationCounter counter(state);
+    for(auto _ : state){
+        benchmark::DoNotOptimize(move.executeAll());
+    }
+}
+BENCHMARK(moveExecuteAll);
+
+static void moveApplyUndo(benchmark::State &state) {
+    auto env = fixtures::createCrowdedEnv();
+    gameController::Move move(env, env->team2->chasers[0], env->team1->chasers[0]->position);
+    const auto outcomes = move.getOutcomes();
+    fixtures::AllocationCounter counter(state);
+    for(auto _ : state){
+        for(const auto &outcome : outcomes){
+            move.apply(outcome);
+            move.undo();
+        }
+    }
+
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * outcomes.size()));
+}
+BENCHMARK(moveApplyUndo);
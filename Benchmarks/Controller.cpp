@@ -0,0 +1,172 @@
+//
+// Benchmarks for the game controller
+//
+
+#include "fixtures.h"
+#include "GameController.h"
+#include "Action.h"
+#include "MatchSimulator.h"
+#include "MatchFarm.h"
+#include "Expectimax.h"
+#include "Mcts.h"
+
+static void getAllCrossedCells(benchmark::State &state) {
+    const gameModel::Position start{1, 4};
+    const gameModel::Position end{15, 9};
+    fixtures::AllocationCounter counter(state);
+    for(auto _ : state){
+        benchmark::DoNotOptimize(gameController::getAllCrossedCells(start, end));
+    }
+}
+BENCHMARK(getAllCrossedCells);
+
+static void getAllPossibleShotsQuaffle(benchmark::State &state, fixtures::EnvFactory createEnv) {
+    auto env = createEnv();
+    auto actor = env->team1->chasers[0];
+    env->quaffle->position = actor->position;
+    fixtures::AllocationCounter counter(state);
+    for(auto _ : state){
+        benchmark::DoNotOptimize(gameController::getAllPossibleShots(actor, env, 0));
+    }
+}
+BENCHMARK_CAPTURE(getAllPossibleShotsQuaffle, setup, &fixtures::createSetupEnv);
+BENCHMARK_CAPTURE(getAllPossibleShotsQuaffle, crowded, &fixtures::createCrowdedEnv);
+
+static void getAllPossibleShotsBludger(benchmark::State &state, fixtures::EnvFactory createEnv) {
+    auto env = createEnv();
+    auto actor = env->team1->beaters[0];
+    env->bludgers[0]->position = actor->position;
+    fixtures::AllocationCounter counter(state);
+    for(auto _ : state){
+        benchmark::DoNotOptimize(gameController::getAllPossibleShots(actor, env, 0));
+    }
+}
+BENCHMARK_CAPTURE(getAllPossibleShotsBludger, setup, &fixtures::createSetupEnv);
+BENCHMARK_CAPTURE(getAllPossibleShotsBludger, crowded, &fixtures::createCrowdedEnv);
+
+static void getAllConstrainedShots(benchmark::State &state, fixtures::EnvFactory createEnv) {
+    auto env = createEnv();
+    auto actor = env->team1->chasers[0];
+    env->quaffle->position = actor->position;
+    fixtures::AllocationCounter counter(state);
+    for(auto _ : state){
+        benchmark::DoNotOptimize(gameController::getAllConstrainedShots(actor, env));
+    }
+}
+BENCHMARK_CAPTURE(getAllConstrainedShots, setup, &fixtures::createSetupEnv);
+BENCHMARK_CAPTURE(getAllConstrainedShots, crowded, &fixtures::createCrowdedEnv);
+
+static void getAllPossibleMoves(benchmark::State &state, fixtures::EnvFactory createEnv) {
+    auto env = createEnv();
+    auto actor = env->team1->chasers[0];
+    fixtures::AllocationCounter counter(state);
+    for(auto _ : state){
+        benchmark::DoNotOptimize(gameController::getAllPossibleMoves(actor, env));
+    }
+}
+BENCHMARK_CAPTURE(getAllPossibleMoves, setup, &fixtures::createSetupEnv);
+BENCHMARK_CAPTURE(getAllPossibleMoves, crowded, &fixtures::createCrowdedEnv);
+
+// The mutating benchmarks below reset the state with CompactEnvironment::applyTo, which does not allocate
+
+static void moveBludger(benchmark::State &state, fixtures::EnvFactory createEnv) {
+    auto env = createEnv();
+    const gameModel::CompactEnvironment initial(*env);
+    fixtures::AllocationCounter counter(state);
+    for(auto _ : state){
+        initial.applyTo(*env);
+        benchmark::DoNotOptimize(gameController::moveBludger(env->bludgers[1], env));
+    }
+}
+BENCHMARK_CAPTURE(moveBludger, setup, &fixtures::createSetupEnv);
+BENCHMARK_CAPTURE(moveBludger, crowded, &fixtures::createCrowdedEnv);
+
+static void moveSnitch(benchmark::State &state, fixtures::EnvFactory createEnv) {
+    auto env = createEnv();
+    env->snitch->exists = true;
+    const gameModel::CompactEnvironment initial(*env);
+    fixtures::AllocationCounter counter(state);
+    for(auto _ : state){
+        initial.applyTo(*env);
+        benchmark::DoNotOptimize(gameController::moveSnitch(env->snitch, env, gameController::ExcessLength::None));
+    }
+}
+BENCHMARK_CAPTURE(moveSnitch, setup, &fixtures::createSetupEnv);
+BENCHMARK_CAPTURE(moveSnitch, crowded, &fixtures::createCrowdedEnv);
+
+static void spawnSnitch(benchmark::State &state, fixtures::EnvFactory createEnv) {
+    auto env = createEnv();
+    env->snitch->exists = false;
+    const gameModel::CompactEnvironment initial(*env);
+    fixtures::AllocationCounter counter(state);
+    for(auto _ : state){
+        initial.applyTo(*env);
+        gameController::spawnSnitch(env);
+        benchmark::DoNotOptimize(env->snitch->position);
+    }
+}
+BENCHMARK_CAPTURE(spawnSnitch, setup, &fixtures::createSetupEnv);
+BENCHMARK_CAPTURE(spawnSnitch, crowded, &fixtures::createCrowdedEnv);
+
+static void simulateMatch(benchmark::State &state) {
+    gameController::MatchSimulator simulator(fixtures::createSetupEnv(), gameController::randomPolicy(),
+                                             gameController::randomPolicy());
+    std::uint64_t seed = 0;
+    std::size_t rounds = 0;
+    fixtures::AllocationCounter counter(state);
+    for(auto _ : state){
+        rounds += simulator.run(seed++).rounds;
+    }
+
+    state.counters["rounds/match"] = benchmark::Counter(static_cast<double>(rounds), benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(simulateMatch);
+
+static void matchFarm(benchmark::State &state) {
+    constexpr std::uint64_t MATCHES = 64;
+    gameController::MatchFarm farm(fixtures::createSetupEnv(), gameController::randomPolicy(),
+                                   gameController::randomPolicy(), static_cast<unsigned int>(state.range(0)));
+    std::uint64_t seed = 0;
+    for(auto _ : state){
+        benchmark::DoNotOptimize(farm.run(MATCHES, seed));
+        seed += MATCHES;
+    }
+
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * MATCHES));
+}
+BENCHMARK(matchFarm)->RangeMultiplier(2)->Range(1, 8)->UseRealTime();
+
+static void expectimax(benchmark::State &state, gameController::Expectimax::ChancePruning pruning) {
+    using ID = communication::messages::types::EntityId;
+    auto env = fixtures::createCrowdedEnv();
+    const std::vector<ID> turnOrder{ID::LEFT_CHASER1, ID::RIGHT_CHASER1, ID::LEFT_CHASER2, ID::RIGHT_CHASER2};
+    const gameController::SearchLimits limits{static_cast<unsigned int>(state.range(0)), std::chrono::hours(1)};
+    std::uint64_t nodes = 0;
+    for(auto _ : state){
+        gameController::Expectimax engine(gameController::scoreEvaluation(), -1, 1, pruning);
+        nodes += engine.search(env, turnOrder, limits).nodes;
+    }
+
+    state.counters["nodes"] = benchmark::Counter(static_cast<double>(nodes), benchmark::Counter::kAvgIterations);
+}
+BENCHMARK_CAPTURE(expectimax, none, gameController::Expectimax::ChancePruning::None)->DenseRange(1, 3);
+BENCHMARK_CAPTURE(expectimax, star1, gameController::Expectimax::ChancePruning::Star1)->DenseRange(1, 3);
+BENCHMARK_CAPTURE(expectimax, star2, gameController::Expectimax::ChancePruning::Star2)->DenseRange(1, 3);
+
+static void mcts(benchmark::State &state, gameController::Mcts::Parallelism parallelism) {
+    using ID = communication::messages::types::EntityId;
+    auto env = fixtures::createCrowdedEnv();
+    const std::vector<ID> turnOrder{ID::LEFT_CHASER1, ID::RIGHT_CHASER1, ID::LEFT_CHASER2, ID::RIGHT_CHASER2};
+    gameController::Mcts::Options options;
+    options.threads = static_cast<unsigned int>(state.range(0));
+    options.parallelism = parallelism;
+    gameController::Mcts engine(gameController::scoreEvaluation(), -1, 1, options);
+    std::uint64_t iterations = 0;
+    for(auto _ : state){
+        iterations += engine.search(env, turnOrder, {10000, std::chrono::hours(1)}).iterations;
+    }
+
+    state.counters["iterations"] = benchmark::Counter(static_cast<double>(iterations), benchmark::Counter::kIsRate);
+}
+BENCHMARK_CAPTURE(mcts, tree, gameController::Mcts::Parallelism::Tree)->RangeMultiplier(2)->Range(1, 8)->UseRealTime();
+BENCHMARK_CAPTURE(mcts, root, gameController::Mcts::Parallelism::Root)->RangeMultiplier(2)->Range(1, 8)->UseRealTime();
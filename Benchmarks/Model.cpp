@@ -0,0 +1,141 @@
+//
+// Benchmarks for the game model
+//
+
+#include <cstdio>
+#include "fixtures.h"
+#include "SharedPtrSerialization.h"
+#include "BinarySerialization.h"
+#include "Delta.h"
+#include "Replay.h"
+#include "conversions.h"
+
+static void getCell(benchmark::State &state) {
+    fixtures::AllocationCounter counter(state);
+    for(auto _ : state){
+        for(int x = -1; x <= gameModel::FIELD_WIDTH; x++){
+            for(int y = -1; y <= gameModel::FIELD_HEIGHT; y++){
+                benchmark::DoNotOptimize(gameModel::Environment::getCell(x, y));
+            }
+        }
+    }
+}
+BENCHMARK(getCell);
+
+static void getObjectById(benchmark::State &state) {
+    using Id = communication::messages::types::EntityId;
+    auto env = fixtures::createSetupEnv();
+    const std::array<Id, 18> ids{Id::LEFT_SEEKER, Id::LEFT_KEEPER, Id::LEFT_BEATER1, Id::LEFT_BEATER2,
+                                 Id::LEFT_CHASER1, Id::LEFT_CHASER2, Id::LEFT_CHASER3, Id::RIGHT_SEEKER,
+                                 Id::RIGHT_KEEPER, Id::RIGHT_BEATER1, Id::RIGHT_BEATER2, Id::RIGHT_CHASER1,
+                                 Id::RIGHT_CHASER2, Id::RIGHT_CHASER3, Id::QUAFFLE, Id::SNITCH, Id::BLUDGER1,
+                                 Id::BLUDGER2};
+    fixtures::AllocationCounter counter(state);
+    for(auto _ : state){
+        for(auto id : ids){
+            if(gameLogic::conversions::isPlayer(id)){
+                benchmark::DoNotOptimize(env->getPlayerById(id));
+            } else {
+                benchmark::DoNotOptimize(env->getBallByID(id));
+            }
+        }
+    }
+}
+BENCHMARK(getObjectById);
+
+static void clone(benchmark::State &state, fixtures::EnvFactory createEnv) {
+    auto env = createEnv();
+    fixtures::AllocationCounter counter(state);
+    for(auto _ : state){
+        benchmark::DoNotOptimize(env->clone());
+    }
+}
+BENCHMARK_CAPTURE(clone, setup, &fixtures::createSetupEnv);
+BENCHMARK_CAPTURE(clone, crowded, &fixtures::createCrowdedEnv);
+
+static void cloneArena(benchmark::State &state, fixtures::EnvFactory createEnv) {
+    auto env = createEnv();
+    std::vector<std::byte> buffer(1 << 14);
+    std::pmr::monotonic_buffer_resource arena(buffer.data(), buffer.size());
+    fixtures::AllocationCounter counter(state);
+    for(auto _ : state){
+        benchmark::DoNotOptimize(env->clone(&arena));
+        arena.release();
+    }
+}
+BENCHMARK_CAPTURE(cloneArena, setup, &fixtures::createSetupEnv);
+BENCHMARK_CAPTURE(cloneArena, crowded, &fixtures::createCrowdedEnv);
+
+static void getAllFreeCells(benchmark::State &state, fixtures::EnvFactory createEnv) {
+    auto env = createEnv();
+    fixtures::AllocationCounter counter(state);
+    for(auto _ : state){
+        benchmark::DoNotOptimize(env->getAllFreeCells());
+    }
+}
+BENCHMARK_CAPTURE(getAllFreeCells, setup, &fixtures::createSetupEnv);
+BENCHMARK_CAPTURE(getAllFreeCells, crowded, &fixtures::createCrowdedEnv);
+
+static void jsonRoundTrip(benchmark::State &state, fixtures::EnvFactory createEnv) {
+    auto env = createEnv();
+    fixtures::AllocationCounter counter(state);
+    for(auto _ : state){
+        nlohmann::json json = env;
+        benchmark::DoNotOptimize(json.get<std::shared_ptr<gameModel::Environment>>());
+    }
+}
+BENCHMARK_CAPTURE(jsonRoundTrip, setup, &fixtures::createSetupEnv);
+BENCHMARK_CAPTURE(jsonRoundTrip, crowded, &fixtures::createCrowdedEnv);
+
+static void binaryRoundTrip(benchmark::State &state, fixtures::EnvFactory createEnv) {
+    auto env = createEnv();
+    fixtures::AllocationCounter counter(state);
+    for(auto _ : state){
+        benchmark::DoNotOptimize(gameModel::fromBinary(gameModel::toBinary(*env)));
+    }
+
+    state.counters["bytes"] = static_cast<double>(gameModel::toBinary(*env).size());
+}
+BENCHMARK_CAPTURE(binaryRoundTrip, setup, &fixtures::createSetupEnv);
+BENCHMARK_CAPTURE(binaryRoundTrip, crowded, &fixtures::createCrowdedEnv);
+
+static void deltaRoundTrip(benchmark::State &state, fixtures::EnvFactory createEnv) {
+    auto from = createEnv();
+    auto to = from->clone();
+    to->quaffle->position = {gameModel::FIELD_WIDTH / 2, gameModel::FIELD_HEIGHT / 2 + 1};
+    to->team1->chasers[0]->position = to->quaffle->position;
+    auto target = from->clone();
+    fixtures::AllocationCounter counter(state);
+    for(auto _ : state){
+        gameModel::apply(*target, gameModel::deltaFromBinary(gameModel::toBinary(gameModel::diff(*from, *to))));
+        benchmark::DoNotOptimize(target);
+    }
+
+    state.counters["bytes"] = static_cast<double>(gameModel::toBinary(gameModel::diff(*from, *to)).size());
+}
+BENCHMARK_CAPTURE(deltaRoundTrip, setup, &fixtures::createSetupEnv);
+BENCHMARK_CAPTURE(deltaRoundTrip, crowded, &fixtures::createCrowdedEnv);
+
+static void replaySeek(benchmark::State &state) {
+    const std::string path = "benchmark_replay.bin";
+    auto env = fixtures::createSetupEnv();
+    {
+        gameModel::ReplayWriter writer(path);
+        for(int i = 0; i < 256; i++){
+            env->getAllPlayers()[i % 14]->position = {i % gameModel::FIELD_WIDTH, i % gameModel::FIELD_HEIGHT};
+            env->quaffle->position = env->getAllPlayers()[i % 14]->position;
+            writer.append(*env);
+        }
+    }
+
+    gameModel::ReplayReader reader(path);
+    fixtures::AllocationCounter counter(state);
+    std::size_t frame = 0;
+    for(auto _ : state){
+        benchmark::DoNotOptimize(reader.getFrame(frame));
+        frame = (frame + 97) % reader.frameCount();
+    }
+
+    std::remove(path.c_str());
+}
+BENCHMARK(replaySeek);
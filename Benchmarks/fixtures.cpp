@@ -0,0 +1,98 @@
+//
+// Fixture positions and helpers shared by all benchmarks
+//
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include "fixtures.h"
+#include "setup.h"
+
+namespace {
+    std::atomic<std::size_t> allocations{0};
+}
+
+void *operator new(std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if(auto ptr = std::malloc(size == 0 ? 1 : size)){
+        return ptr;
+    }
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    const auto align = static_cast<std::size_t>(alignment);
+    if(auto ptr = std::aligned_alloc(align, (size + align - 1) / align * align)){
+        return ptr;
+    }
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void *ptr, std::align_val_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t, std::align_val_t) noexcept {
+    std::free(ptr);
+}
+
+namespace fixtures {
+    auto createConfig() -> gameModel::Config {
+        using B = communication::messages::types::Broom;
+        std::map<B, double> brooms{{B::TINDERBLAST, 0.05}, {B::CLEANSWEEP11, 0.1}, {B::COMET260, 0.15},
+                                   {B::NIMBUS2001, 0.2}, {B::FIREBOLT, 0.25}};
+        return {20, {0.5, 0.5, 0.5, 0.5, 0.5, 0.3, 0.3, 0.3, 0.3, 0.3}, {0.8, 0.4, 0.3, 0.6, 0.5}, brooms};
+    }
+
+    auto createSetupEnv() -> std::shared_ptr<gameModel::Environment> {
+        auto env = setup::createEnv(createConfig());
+        for (const auto &player : env->getAllPlayers()) {
+            player->broom = communication::messages::types::Broom::COMET260;
+        }
+
+        return env;
+    }
+
+    auto createCrowdedEnv() -> std::shared_ptr<gameModel::Environment> {
+        auto env = createSetupEnv();
+        env->team1->chasers[0]->position = {7, 6};
+        env->team1->chasers[1]->position = {8, 5};
+        env->team1->chasers[2]->position = {9, 7};
+        env->team1->beaters[0]->position = {7, 4};
+        env->team1->seeker->position = {6, 7};
+        env->team2->chasers[0]->position = {8, 7};
+        env->team2->chasers[1]->position = {9, 6};
+        env->team2->chasers[2]->position = {9, 5};
+        env->team2->beaters[0]->position = {10, 6};
+        env->team2->seeker->position = {10, 8};
+        env->quaffle->position = env->team1->chasers[0]->position;
+        env->bludgers[0]->position = env->team1->beaters[0]->position;
+        env->bludgers[1]->position = {8, 8};
+        env->snitch->exists = true;
+        env->snitch->position = {11, 4};
+        env->pileOfShit.emplace_back(std::make_shared<gameModel::CubeOfShit>(gameModel::Position{7, 7}));
+        return env;
+    }
+
+    auto allocationCount() -> std::size_t {
+        return allocations.load(std::memory_order_relaxed);
+    }
+
+    AllocationCounter::AllocationCounter(benchmark::State &state) : state(state), start(allocationCount()) {}
+
+    AllocationCounter::~AllocationCounter() {
+        state.counters["allocs/op"] = benchmark::Counter(static_cast<double>(allocationCount() - start),
+                benchmark::Counter::kAvgIterations);
+    }
+}
@@ -0,0 +1,49 @@
+//
+// Fixture positions and helpers shared by all benchmarks
+//
+
+#ifndef SOPRAGAMELOGIC_BENCHMARK_FIXTURES_H
+#define SOPRAGAMELOGIC_BENCHMARK_FIXTURES_H
+
+#include <cstddef>
+#include <benchmark/benchmark.h>
+#include "GameModel.h"
+
+namespace fixtures {
+    using EnvFactory = std::shared_ptr<gameModel::Environment>(*)();
+
+    /**
+     * Config with all probabilities set, required for JSON serialization
+     */
+    auto createConfig() -> gameModel::Config;
+
+    /**
+     * Positions from Tests/setup.cpp, all players fly a broom listed in createConfig
+     */
+    auto createSetupEnv() -> std::shared_ptr<gameModel::Environment>;
+
+    /**
+     * Both teams crowded around the quaffle in midfield, with a cube of shit and an existing snitch
+     */
+    auto createCrowdedEnv() -> std::shared_ptr<gameModel::Environment>;
+
+    /**
+     * Gets the number of heap allocations since program start
+     */
+    auto allocationCount() -> std::size_t;
+
+    /**
+     * Measures the heap allocations of a benchmark, reported as allocs/op
+     */
+    class AllocationCounter {
+    public:
+        explicit AllocationCounter(benchmark::State &state);
+        ~AllocationCounter();
+
+    private:
+        benchmark::State &state;
+        std::size_t start;
+    };
+}
+
+#endif //SOPRAGAMELOGIC_BENCHMARK_FIXTURES_H
@@ -0,0 +1,134 @@
+#include <gtest/gtest.h>
+#include <limits>
+#include "BinarySerialization.h"
+#include "SharedPtrSerialization.h"
+#include "setup.h"
+
+namespace {
+    auto createEnv() -> std::shared_ptr<gameModel::Environment> {
+        using B = communication::messages::types::Broom;
+        auto env = setup::createEnv(setup::createConfig(30, {0.1, 0.2, 0.3, 0.4, 0.5, 0.6, 0.7, 0.8, 0.9, 0.15},
+                                                        {0.25, 0.35, 0.45, 0.55, 0.65}));
+        env->team1->score = 130;
+        env->team2->score = -20;
+        env->team1->fanblock.banFan(gameModel::InterferenceType::Impulse);
+        env->team2->fanblock.banFan(gameModel::InterferenceType::Teleport);
+        env->team1->chasers[1]->isFined = true;
+        env->team2->beaters[0]->knockedOut = true;
+        env->team2->keeper->broom = B::FIREBOLT;
+        env->snitch->exists = true;
+        env->snitch->position = {16, 12};
+        env->quaffle->position = {0, 0};
+        for (int i = 0; i < 20; i++) {
+            env->pileOfShit.emplace_back(std::make_shared<gameModel::CubeOfShit>(gameModel::Position{i % 17, i % 13}));
+            env->pileOfShit.back()->spawnedThisRound = i % 3 == 0;
+        }
+
+        return env;
+    }
+}
+
+TEST(binary_serialization_test, round_trip){
+    auto env = createEnv();
+    auto data = gameModel::toBinary(*env);
+    auto decoded = gameModel::fromBinary(data);
+    EXPECT_EQ(*decoded, *env);
+    EXPECT_EQ(decoded->config, env->config);
+    ASSERT_EQ(decoded->pileOfShit.size(), env->pileOfShit.size());
+    for (std::size_t i = 0; i < env->pileOfShit.size(); i++) {
+        EXPECT_EQ(*decoded->pileOfShit[i], *env->pileOfShit[i]);
+    }
+
+    EXPECT_EQ(gameModel::toBinary(*decoded), data);
+}
+
+TEST(binary_serialization_test, json_round_trip){
+    auto env = createEnv();
+    nlohmann::json json = env;
+    auto fromJson = json.get<std::shared_ptr<gameModel::Environment>>();
+    auto data = gameModel::toBinary(*fromJson);
+    auto decoded = gameModel::fromBinary(data);
+    EXPECT_EQ(*decoded, *fromJson);
+    nlohmann::json decodedJson = decoded;
+    EXPECT_EQ(decodedJson, json);
+    EXPECT_LT(data.size() * 10, json.dump().size());
+}
+
+TEST(binary_serialization_test, without_config){
+    auto env = createEnv();
+    auto data = gameModel::toBinary(*env, false);
+    EXPECT_LT(data.size(), gameModel::toBinary(*env).size());
+    EXPECT_THROW(gameModel::fromBinary(data), std::runtime_error);
+    auto decoded = gameModel::fromBinary(data, env->config);
+    EXPECT_EQ(*decoded, *env);
+    EXPECT_EQ(decoded->config, env->config);
+}
+
+TEST(binary_serialization_test, malformed_data){
+    auto data = gameModel::toBinary(*createEnv());
+    for (std::size_t size = 0; size < data.size(); size++) {
+        EXPECT_THROW(gameModel::fromBinary({data.begin(), data.begin() + static_cast<long>(size)}), std::runtime_error);
+    }
+
+    auto trailing = data;
+    trailing.push_back(0);
+    EXPECT_THROW(gameModel::fromBinary(trailing), std::runtime_error);
+
+    auto version = data;
+    version[2] = gameModel::BINARY_FORMAT_VERSION + 1;
+    EXPECT_THROW(gameModel::fromBinary(version), std::runtime_error);
+
+    auto magic = data;
+    magic[0] = 'X';
+    EXPECT_THROW(gameModel::fromBinary(magic), std::runtime_error);
+
+    auto env = createEnv();
+    env->quaffle->position = {17, 0};
+    EXPECT_THROW(gameModel::toBinary(*env), std::invalid_argument);
+}
+
+TEST(binary_serialization_test, invalid_broom){
+    auto env = createEnv();
+    env->team2->chasers[1]->broom = static_cast<communication::messages::types::Broom>(5);
+    EXPECT_THROW(gameModel::fromBinary(gameModel::toBinary(*env)), std::runtime_error);
+}
+
+TEST(binary_serialization_test, invalid_player_ids){
+    using ID = communication::messages::types::EntityId;
+    auto env = createEnv();
+    env->team1->seeker = std::make_shared<gameModel::Seeker>(gameModel::Position{5, 4}, env->team1->seeker->broom,
+                                                             ID::LEFT_CHASER1);
+    EXPECT_THROW(gameModel::fromBinary(gameModel::toBinary(*env)), std::runtime_error);
+
+    env = createEnv();
+    env->team2->beaters[0] = std::make_shared<gameModel::Beater>(gameModel::Position{0, 6},
+                                                                 env->team2->beaters[0]->broom, ID::LEFT_BEATER1);
+    EXPECT_THROW(gameModel::fromBinary(gameModel::toBinary(*env)), std::runtime_error);
+}
+
+TEST(binary_serialization_test, primitives){
+    std::vector<std::uint8_t> buffer;
+    gameModel::BinaryWriter writer(buffer);
+    const std::vector<std::int64_t> values = {0, 1, -1, 63, -64, 64, 1000000, std::numeric_limits<std::int64_t>::min(),
+                                              std::numeric_limits<std::int64_t>::max()};
+    for (auto value : values) {
+        writer.writeSignedVarint(value);
+        writer.writeVarint(static_cast<std::uint64_t>(value));
+    }
+
+    writer.writeDouble(0.1);
+    writer.writeUint32(0xDEADBEEF);
+    writer.writeCell({16, 12});
+
+    gameModel::BinaryReader reader(buffer.data(), buffer.size());
+    for (auto value : values) {
+        EXPECT_EQ(reader.readSignedVarint(), value);
+        EXPECT_EQ(reader.readVarint(), static_cast<std::uint64_t>(value));
+    }
+
+    EXPECT_EQ(reader.readDouble(), 0.1);
+    EXPECT_EQ(reader.readUint32(), 0xDEADBEEF);
+    EXPECT_EQ(reader.readCell(), gameModel::Position(16, 12));
+    EXPECT_EQ(reader.remaining(), 0);
+    EXPECT_THROW(reader.readByte(), std::runtime_error);
+}
@@ -90,6 +90,52 @@ TEST(controller_test, getAllCrossedCells3) {
     EXPECT_EQ(result[9], expected[9]);
 }
 
+TEST(controller_test, getCrossedCellsView_matches_reference) {
+    // original floating point traversal
+    auto reference = [](const gameModel::Position &start, const gameModel::Position &end){
+        std::vector<gameModel::Position> ret;
+        if (start == end) {
+            return ret;
+        }
+
+        gameModel::Vector dirVect(end.x - start.x, end.y - start.y);
+        dirVect.normalize();
+        gameModel::Vector travVect(0, 0);
+        gameModel::Position lastCell = start;
+        while ((travVect + start) != end) {
+            if ((travVect + start) != lastCell) {
+                lastCell = travVect + start;
+                if (gameModel::Environment::getCell(lastCell) != gameModel::Cell::OutOfBounds) {
+                    ret.emplace_back(lastCell);
+                }
+            }
+
+            travVect = travVect + (dirVect * 0.5);
+        }
+
+        return ret;
+    };
+
+    for (const auto &start : gameModel::Environment::getAllValidCells()) {
+        for (const auto &end : gameModel::Environment::getAllValidCells()) {
+            auto view = gameController::getCrossedCellsView(start, end);
+            auto expected = reference(start, end);
+            ASSERT_EQ(view.size(), expected.size());
+            for (std::size_t i = 0; i < expected.size(); i++) {
+                ASSERT_EQ(view[i], expected[i]);
+            }
+
+            EXPECT_EQ(std::vector<gameModel::Position>(view.begin(), view.end()), expected);
+        }
+    }
+}
+
+TEST(controller_test, getCrossedCellsView_out_of_bounds) {
+    EXPECT_THROW(gameController::getCrossedCellsView({0, 0}, {8, 6}), std::out_of_range);
+    EXPECT_THROW(gameController::getAllCrossedCells({8, 6}, {17, 6}), std::out_of_range);
+    EXPECT_TRUE(gameController::getCrossedCellsView({8, 6}, {8, 6}).empty());
+}
+
 //-----------------------------------Bludger Move Test------------------------------------------------------------------
 
 TEST(controller_test, moveBludger_towards_player) {
@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+#include "Delta.h"
+#include "BinarySerialization.h"
+#include "setup.h"
+
+namespace {
+    auto createEnv() -> std::shared_ptr<gameModel::Environment> {
+        auto env = setup::createEnv();
+        for (int i = 0; i < 6; i++) {
+            env->pileOfShit.emplace_back(std::make_shared<gameModel::CubeOfShit>(gameModel::Position{i, i}));
+            env->pileOfShit.back()->spawnedThisRound = i % 2 == 0;
+        }
+
+        return env;
+    }
+
+    auto change(const std::shared_ptr<gameModel::Environment> &env) -> std::shared_ptr<gameModel::Environment> {
+        using B = communication::messages::types::Broom;
+        auto ret = env->clone();
+        ret->team1->chasers[0]->position = {8, 6};
+        ret->team2->seeker->position = {3, 4};
+        ret->team2->keeper->isFined = true;
+        ret->team1->beaters[1]->knockedOut = true;
+        ret->team1->seeker->broom = B::NIMBUS2001;
+        ret->quaffle->position = {7, 7};
+        ret->bludgers[1]->position = {10, 2};
+        ret->snitch->exists = !env->snitch->exists;
+        ret->team2->score += 30;
+        ret->team1->fanblock.banFan(gameModel::InterferenceType::SnitchPush);
+        ret->pileOfShit.erase(ret->pileOfShit.begin() + 1);
+        ret->pileOfShit.erase(ret->pileOfShit.begin() + 3);
+        ret->pileOfShit[0]->spawnedThisRound = false;
+        ret->pileOfShit.emplace_back(std::make_shared<gameModel::CubeOfShit>(gameModel::Position{16, 12}));
+        ret->pileOfShit.back()->spawnedThisRound = true;
+        return ret;
+    }
+
+    void expectEqual(const gameModel::Environment &a, const gameModel::Environment &b) {
+        EXPECT_EQ(a, b);
+        EXPECT_EQ(a.snitch->exists, b.snitch->exists);
+        for (auto type : {gameModel::InterferenceType::Teleport, gameModel::InterferenceType::RangedAttack,
+                          gameModel::InterferenceType::Impulse, gameModel::InterferenceType::SnitchPush,
+                          gameModel::InterferenceType::BlockCell}) {
+            EXPECT_EQ(a.team1->fanblock.getUses(type), b.team1->fanblock.getUses(type));
+            EXPECT_EQ(a.team1->fanblock.getBannedCount(type), b.team1->fanblock.getBannedCount(type));
+        }
+
+        ASSERT_EQ(a.pileOfShit.size(), b.pileOfShit.size());
+        for (std::size_t i = 0; i < a.pileOfShit.size(); i++) {
+            EXPECT_EQ(*a.pileOfShit[i], *b.pileOfShit[i]);
+        }
+    }
+}
+
+TEST(delta_test, diff_apply){
+    auto from = createEnv();
+    auto to = change(from);
+    auto delta = gameModel::diff(*from, *to);
+    EXPECT_EQ(delta.moves.size(), 4);
+    EXPECT_EQ(delta.playerFlags.size(), 3);
+    EXPECT_EQ(delta.scores.size(), 1);
+    EXPECT_EQ(delta.fans.size(), 1);
+    EXPECT_EQ(delta.removedCubes, (std::vector<std::size_t>{1, 4}));
+    EXPECT_EQ(delta.addedCubes.size(), 1);
+    gameModel::apply(*from, delta);
+    expectEqual(*from, *to);
+    EXPECT_TRUE(gameModel::diff(*from, *to).empty());
+}
+
+TEST(delta_test, equal_envs){
+    auto env = createEnv();
+    auto delta = gameModel::diff(*env, *env->clone());
+    EXPECT_TRUE(delta.empty());
+    EXPECT_EQ(nlohmann::json(delta).dump(), "{}");
+}
+
+TEST(delta_test, serialization){
+    auto from = createEnv();
+    auto to = change(from);
+    auto delta = gameModel::diff(*from, *to);
+
+    nlohmann::json json = delta;
+    EXPECT_EQ(json.get<gameModel::Delta>(), delta);
+
+    auto data = gameModel::toBinary(delta);
+    EXPECT_EQ(gameModel::deltaFromBinary(data), delta);
+    EXPECT_LT(data.size() * 2, gameModel::toBinary(*to, false).size());
+
+    for (std::size_t size = 0; size < data.size(); size++) {
+        EXPECT_THROW(gameModel::deltaFromBinary({data.begin(), data.begin() + static_cast<long>(size)}),
+                     std::runtime_error);
+    }
+
+    data.push_back(0);
+    EXPECT_THROW(gameModel::deltaFromBinary(data), std::runtime_error);
+}
+
+TEST(delta_test, invalid_player_flags){
+    using ID = communication::messages::types::EntityId;
+    gameModel::Delta delta;
+    delta.playerFlags.push_back({ID::LEFT_KEEPER, false, false, static_cast<communication::messages::types::Broom>(6)});
+    EXPECT_THROW(gameModel::deltaFromBinary(gameModel::toBinary(delta)), std::runtime_error);
+
+    delta.playerFlags[0] = {ID::BLUDGER1, false, false, communication::messages::types::Broom::FIREBOLT};
+    EXPECT_THROW(gameModel::deltaFromBinary(gameModel::toBinary(delta)), std::runtime_error);
+
+    delta.playerFlags[0].id = ID::LEFT_KEEPER;
+    EXPECT_EQ(gameModel::deltaFromBinary(gameModel::toBinary(delta)), delta);
+}
+
+TEST(delta_test, invalid_delta){
+    auto env = createEnv();
+    gameModel::Delta delta;
+    delta.removedCubes.push_back(env->pileOfShit.size());
+    EXPECT_THROW(gameModel::apply(*env, delta), std::invalid_argument);
+
+    delta = {};
+    delta.moves.push_back({communication::messages::types::EntityId::LEFT_WOMBAT, {0, 0}});
+    EXPECT_THROW(gameModel::apply(*env, delta), std::invalid_argument);
+}
@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include "Expectimax.h"
+#include "setup.h"
+
+namespace {
+    using ID = communication::messages::types::EntityId;
+
+    auto createEnv() -> std::shared_ptr<gameModel::Environment> {
+        auto env = setup::createEnv({0, {0.5, 0.5, 0.5, 0.5, 0.5, 0.3, 0.3, 0.3, 0.3, 0.3},
+                                     {0.8, 0.4, 0.3, 0.6, 0.5}, {}});
+        env->team1->chasers[2]->position = {11, 6};
+        env->quaffle->position = env->team1->chasers[2]->position;
+        env->team2->chasers[1]->position = {12, 7};
+        return env;
+    }
+
+    auto search(gameController::Expectimax::ChancePruning pruning, unsigned int depth) -> gameController::SearchResult {
+        gameController::Expectimax engine(gameController::scoreEvaluation(), -1, 1, pruning);
+        return engine.search(createEnv(), {ID::LEFT_CHASER3, ID::RIGHT_CHASER2}, {depth, std::chrono::hours(1)});
+    }
+}
+
+TEST(expectimax_test, pruning_keeps_value){
+    using Pruning = gameController::Expectimax::ChancePruning;
+    for (unsigned int depth = 1; depth <= 3; depth++) {
+        auto plain = search(Pruning::None, depth);
+        auto star1 = search(Pruning::Star1, depth);
+        auto star2 = search(Pruning::Star2, depth);
+        EXPECT_EQ(plain.depth, depth);
+        EXPECT_NEAR(plain.value, star1.value, 1e-4);
+        EXPECT_NEAR(plain.value, star2.value, 1e-4);
+        EXPECT_LE(star1.nodes, plain.nodes);
+    }
+}
+
+TEST(expectimax_test, scores_goal){
+    auto env = createEnv();
+    env->team1->chasers[2]->position = {13, 6};
+    env->quaffle->position = env->team1->chasers[2]->position;
+    gameController::Expectimax engine(gameController::scoreEvaluation());
+    auto result = engine.search(env, {ID::LEFT_CHASER3}, {1, std::chrono::hours(1)});
+    ASSERT_NE(result.bestAction, nullptr);
+    auto goals = gameModel::Environment::getGoalsRight();
+    EXPECT_NE(std::find(goals.begin(), goals.end(), result.bestAction->getTarget()), goals.end());
+    EXPECT_GT(result.value, 0);
+    EXPECT_EQ(env->quaffle->position, gameModel::Position(13, 6));
+}
+
+TEST(expectimax_test, time_budget){
+    auto env = createEnv();
+    auto original = env->clone();
+    gameController::Expectimax engine(gameController::scoreEvaluation());
+    std::vector<ID> turnOrder;
+    for (const auto &player : env->getAllPlayers()) {
+        turnOrder.emplace_back(player->getId());
+    }
+
+    std::rotate(turnOrder.begin(), std::find(turnOrder.begin(), turnOrder.end(), ID::LEFT_CHASER3), turnOrder.end());
+    auto start = std::chrono::steady_clock::now();
+    auto result = engine.search(env, turnOrder, {64, std::chrono::milliseconds(50)});
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(2));
+    EXPECT_GE(result.depth, 1);
+    EXPECT_LT(result.depth, 64);
+    EXPECT_NE(result.bestAction, nullptr);
+    EXPECT_EQ(*env, *original);
+}
+
+TEST(expectimax_test, actor_cannot_act){
+    auto env = createEnv();
+    env->team1->chasers[2]->isFined = true;
+    gameController::Expectimax engine(gameController::scoreEvaluation());
+    auto result = engine.search(env, {ID::LEFT_CHASER3, ID::RIGHT_CHASER2}, {2, std::chrono::hours(1)});
+    EXPECT_EQ(result.bestAction, nullptr);
+    EXPECT_EQ(result.depth, 2);
+}
+
+TEST(expectimax_test, invalid_arguments){
+    EXPECT_THROW(gameController::Expectimax(gameController::scoreEvaluation(), 1, -1), std::invalid_argument);
+    gameController::Expectimax engine(gameController::scoreEvaluation());
+    EXPECT_THROW(engine.search(createEnv(), {}), std::invalid_argument);
+    EXPECT_THROW(engine.search(createEnv(), {ID::QUAFFLE}), std::invalid_argument);
+}
+
+TEST(expectimax_test, clones_from_search_arena){
+    gameController::Expectimax engine(gameController::scoreEvaluation());
+    gameModel::ScopedCloneResource scope(*std::pmr::null_memory_resource());
+    gameController::SearchResult result;
+    EXPECT_NO_THROW(result = engine.search(createEnv(), {ID::LEFT_CHASER3, ID::RIGHT_CHASER2},
+                                           {2, std::chrono::hours(1)}));
+    EXPECT_NE(result.bestAction, nullptr);
+    EXPECT_EQ(gameModel::getCloneResource(), std::pmr::null_memory_resource());
+}
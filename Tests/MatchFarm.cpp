@@ -0,0 +1,67 @@
+#include <gtest/gtest.h>
+#include <numeric>
+#include "MatchFarm.h"
+#include "setup.h"
+
+namespace {
+    auto createEnv() -> std::shared_ptr<gameModel::Environment> {
+        auto env = setup::createEnv(setup::createConfig(15));
+        for (const auto &player : env->getAllPlayers()) {
+            player->broom = communication::messages::types::Broom::NIMBUS2001;
+        }
+
+        return env;
+    }
+
+    template<std::size_t N>
+    auto sum(const std::array<std::uint64_t, N> &values) -> std::uint64_t {
+        return std::accumulate(values.begin(), values.end(), std::uint64_t{0});
+    }
+}
+
+TEST(match_farm_test, statistics){
+    gameController::MatchFarm farm(createEnv(), gameController::randomPolicy(), gameController::randomPolicy(), 3);
+    EXPECT_EQ(farm.getThreads(), 3);
+    auto stats = farm.run(50, 0);
+    EXPECT_EQ(stats.matches, 50);
+    EXPECT_EQ(stats.winsLeft + stats.winsRight, 50);
+    EXPECT_EQ(stats.snitchCatchesLeft + stats.snitchCatchesRight, 50);
+    EXPECT_EQ(sum(stats.scoreLeft), 50);
+    EXPECT_EQ(sum(stats.scoreRight), 50);
+    EXPECT_EQ(sum(stats.snitchCatchRound), 50);
+    EXPECT_GE(stats.totalScoreLeft + stats.totalScoreRight, 50 * gameController::SNITCH_POINTS);
+    EXPECT_EQ(stats.fouls[static_cast<std::size_t>(gameModel::Foul::None)], 0);
+    EXPECT_DOUBLE_EQ(stats.getWinRate(gameModel::TeamSide::LEFT) + stats.getWinRate(gameModel::TeamSide::RIGHT), 1);
+}
+
+TEST(match_farm_test, independent_of_threads){
+    auto env = createEnv();
+    gameController::MatchFarm single(env, gameController::randomPolicy(), gameController::randomPolicy(), 1);
+    gameController::MatchFarm multi(env, gameController::randomPolicy(), gameController::randomPolicy(), 4);
+    auto expected = single.run(40, 123);
+    EXPECT_EQ(multi.run(40, 123), expected);
+    EXPECT_NE(multi.run(40, 124), expected);
+
+    gameController::MatchSimulator simulator(env, gameController::randomPolicy(), gameController::randomPolicy());
+    gameController::FarmStatistics manual;
+    for (std::uint64_t i = 0; i < 40; i++) {
+        manual.add(simulator.run(123 + i));
+    }
+
+    EXPECT_EQ(manual, expected);
+}
+
+TEST(match_farm_test, no_matches){
+    gameController::MatchFarm farm(createEnv(), gameController::randomPolicy(), gameController::randomPolicy(), 2);
+    EXPECT_EQ(farm.run(0, 0), gameController::FarmStatistics{});
+    EXPECT_DOUBLE_EQ(farm.run(0, 0).getWinRate(gameModel::TeamSide::LEFT), 0);
+}
+
+TEST(match_farm_test, policy_error){
+    auto policy = gameController::randomPolicy();
+    policy.move = [](const auto &, const auto &) -> std::optional<gameModel::Position> {
+        return gameModel::Position{0, 0};
+    };
+    gameController::MatchFarm farm(createEnv(), policy, policy, 2);
+    EXPECT_THROW(farm.run(10, 0), std::runtime_error);
+}
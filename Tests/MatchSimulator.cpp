@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+#include "MatchSimulator.h"
+#include "setup.h"
+
+namespace {
+    auto createEnv(unsigned int maxRounds) -> std::shared_ptr<gameModel::Environment> {
+        auto env = setup::createEnv(setup::createConfig(maxRounds));
+        for (const auto &player : env->getAllPlayers()) {
+            player->broom = communication::messages::types::Broom::COMET260;
+        }
+
+        return env;
+    }
+
+    auto passivePolicy() -> gameController::Policy {
+        auto policy = gameController::randomPolicy();
+        policy.move = [](const auto &, const auto &) { return std::nullopt; };
+        policy.action = [](const auto &, const auto &, auto) { return nullptr; };
+        policy.fan = [](const auto &, const auto &, auto) { return nullptr; };
+        return policy;
+    }
+}
+
+TEST(match_simulator_test, getExcessLength){
+    using gameController::ExcessLength;
+    EXPECT_EQ(gameController::getExcessLength(1, 20), ExcessLength::None);
+    EXPECT_EQ(gameController::getExcessLength(20, 20), ExcessLength::None);
+    EXPECT_EQ(gameController::getExcessLength(21, 20), ExcessLength::Stage1);
+    EXPECT_EQ(gameController::getExcessLength(23, 20), ExcessLength::Stage1);
+    EXPECT_EQ(gameController::getExcessLength(24, 20), ExcessLength::Stage2);
+    EXPECT_EQ(gameController::getExcessLength(26, 20), ExcessLength::Stage2);
+    EXPECT_EQ(gameController::getExcessLength(27, 20), ExcessLength::Stage3);
+    EXPECT_EQ(gameController::getExcessLength(100, 20), ExcessLength::Stage3);
+}
+
+TEST(match_simulator_test, getWinner){
+    gameController::MatchResult result{40, 40, 20, gameModel::TeamSide::RIGHT};
+    EXPECT_EQ(result.getWinner(), gameModel::TeamSide::RIGHT);
+    result.scoreLeft = 50;
+    EXPECT_EQ(result.getWinner(), gameModel::TeamSide::LEFT);
+}
+
+TEST(match_simulator_test, passive_match_ends_in_overtime){
+    auto env = createEnv(20);
+    gameController::MatchSimulator simulator(env, passivePolicy(), passivePolicy());
+    auto result = simulator.run(1);
+    EXPECT_GT(result.rounds, 20);
+    EXPECT_LE(result.rounds, 20 + 2 * gameController::OVERTIME_STAGE_ROUNDS + 1);
+    EXPECT_EQ(result.scoreLeft + result.scoreRight, gameController::SNITCH_POINTS);
+    EXPECT_EQ(result.getWinner(), result.snitchCaughtBy);
+    EXPECT_EQ(env->team1->score, 0);
+    EXPECT_FALSE(env->snitch->exists);
+    EXPECT_TRUE(simulator.getEnvironment().snitch->exists);
+}
+
+TEST(match_simulator_test, random_match){
+    auto env = createEnv(30);
+    gameController::MatchSimulator simulator(env, gameController::randomPolicy(), gameController::randomPolicy());
+    for (std::uint64_t seed = 0; seed < 20; seed++) {
+        auto result = simulator.run(seed);
+        EXPECT_GE(result.rounds, 1);
+        EXPECT_LE(result.rounds, 30 + 2 * gameController::OVERTIME_STAGE_ROUNDS + 1);
+        const auto winnerScore = result.getWinner() == gameModel::TeamSide::LEFT ? result.scoreLeft : result.scoreRight;
+        EXPECT_GE(winnerScore, gameController::SNITCH_POINTS);
+        EXPECT_TRUE(simulator.getEnvironment().pileOfShit.size() <= 14);
+    }
+}
+
+TEST(match_simulator_test, reproducible){
+    auto env = createEnv(30);
+    gameController::MatchSimulator simulator(env, gameController::randomPolicy(), gameController::randomPolicy());
+    auto result = simulator.run(42);
+    auto finalEnv = simulator.getEnvironment().clone();
+    auto replay = simulator.run(42);
+    EXPECT_EQ(result.rounds, replay.rounds);
+    EXPECT_EQ(result.scoreLeft, replay.scoreLeft);
+    EXPECT_EQ(result.scoreRight, replay.scoreRight);
+    EXPECT_EQ(result.snitchCaughtBy, replay.snitchCaughtBy);
+    EXPECT_EQ(*finalEnv, simulator.getEnvironment());
+}
+
+TEST(match_simulator_test, policies_clone_from_caller_resource){
+    auto env = createEnv(30);
+    auto policy = gameController::randomPolicy();
+    std::pmr::memory_resource *policyResource = nullptr;
+    policy.move = [&policyResource, move = policy.move](const auto &matchEnv, const auto &player) {
+        policyResource = gameModel::getCloneResource();
+        EXPECT_NO_THROW(matchEnv->clone());
+        return move(matchEnv, player);
+    };
+
+    gameController::MatchSimulator simulator(env, policy, policy);
+    std::pmr::unsynchronized_pool_resource pool;
+    gameController::MatchResult result;
+    {
+        gameModel::ScopedCloneResource scope(pool);
+        result = simulator.run(7);
+    }
+
+    EXPECT_EQ(policyResource, &pool);
+    auto finalEnv = simulator.getEnvironment().clone();
+    simulator.run(8);
+    EXPECT_EQ(finalEnv->team1->score, result.scoreLeft);
+    EXPECT_EQ(finalEnv->team2->score, result.scoreRight);
+}
@@ -0,0 +1,128 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include "Mcts.h"
+#include "setup.h"
+
+namespace {
+    using ID = communication::messages::types::EntityId;
+
+    auto createEnv() -> std::shared_ptr<gameModel::Environment> {
+        auto env = setup::createEnv({0, {0.5, 0.5, 0.5, 0.5, 0.5, 0.3, 0.3, 0.3, 0.3, 0.3},
+                                     {0.8, 0.4, 0.3, 0.6, 0.5}, {}});
+        env->team1->chasers[2]->position = {13, 6};
+        env->quaffle->position = env->team1->chasers[2]->position;
+        env->team2->chasers[1]->position = {12, 7};
+        return env;
+    }
+
+    auto createOptions(unsigned int threads, gameController::Mcts::Parallelism parallelism) ->
+        gameController::Mcts::Options {
+        gameController::Mcts::Options options;
+        options.threads = threads;
+        options.parallelism = parallelism;
+        options.poolCapacity = 1u << 16u;
+        options.seed = 42;
+        return options;
+    }
+
+    bool isGoal(const std::shared_ptr<gameController::Action> &action) {
+        auto goals = gameModel::Environment::getGoalsRight();
+        return action != nullptr && std::find(goals.begin(), goals.end(), action->getTarget()) != goals.end();
+    }
+}
+
+TEST(mcts_test, scores_goal){
+    auto env = createEnv();
+    gameController::Mcts engine(gameController::scoreEvaluation(), -1, 1,
+                                createOptions(1, gameController::Mcts::Parallelism::Tree));
+    auto result = engine.search(env, {ID::LEFT_CHASER3, ID::RIGHT_CHASER2}, {2000, std::chrono::hours(1)});
+    EXPECT_TRUE(isGoal(result.bestAction));
+    EXPECT_GT(result.value, 0);
+    EXPECT_EQ(result.iterations, 2000);
+    EXPECT_EQ(env->quaffle->position, gameModel::Position(13, 6));
+}
+
+TEST(mcts_test, parallel){
+    using Parallelism = gameController::Mcts::Parallelism;
+    for (auto parallelism : {Parallelism::Tree, Parallelism::Root}) {
+        auto env = createEnv();
+        auto original = env->clone();
+        gameController::Mcts engine(gameController::scoreEvaluation(), -1, 1, createOptions(4, parallelism));
+        auto result = engine.search(env, {ID::LEFT_CHASER3, ID::RIGHT_CHASER2}, {4000, std::chrono::hours(1)});
+        EXPECT_TRUE(isGoal(result.bestAction));
+        EXPECT_GE(result.iterations, 4000);
+        EXPECT_GT(result.nodes, 1);
+        EXPECT_EQ(*env, *original);
+    }
+}
+
+TEST(mcts_test, reproducible){
+    auto search = [] {
+        gameController::Mcts engine(gameController::scoreEvaluation(), -1, 1,
+                                    createOptions(1, gameController::Mcts::Parallelism::Tree));
+        return engine.search(createEnv(), {ID::LEFT_CHASER3, ID::RIGHT_CHASER2}, {500, std::chrono::hours(1)});
+    };
+
+    auto first = search();
+    auto second = search();
+    EXPECT_EQ(first.nodes, second.nodes);
+    EXPECT_DOUBLE_EQ(first.value, second.value);
+    ASSERT_NE(first.bestAction, nullptr);
+    ASSERT_NE(second.bestAction, nullptr);
+    EXPECT_EQ(first.bestAction->getTarget(), second.bestAction->getTarget());
+}
+
+TEST(mcts_test, exhausted_pool){
+    auto options = createOptions(2, gameController::Mcts::Parallelism::Tree);
+    options.poolCapacity = 64;
+    gameController::Mcts engine(gameController::scoreEvaluation(), -1, 1, options);
+    auto result = engine.search(createEnv(), {ID::LEFT_CHASER3, ID::RIGHT_CHASER2}, {1000, std::chrono::hours(1)});
+    EXPECT_LE(result.nodes, 64);
+    EXPECT_GE(result.iterations, 1000);
+    EXPECT_NE(result.bestAction, nullptr);
+}
+
+TEST(mcts_test, time_budget){
+    auto env = createEnv();
+    gameController::Mcts engine(gameController::scoreEvaluation(), -1, 1,
+                                createOptions(2, gameController::Mcts::Parallelism::Tree));
+    auto start = std::chrono::steady_clock::now();
+    auto result = engine.search(env, {ID::LEFT_CHASER3, ID::RIGHT_CHASER2},
+                                {std::numeric_limits<std::uint64_t>::max(), std::chrono::milliseconds(50)});
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(2));
+    EXPECT_GT(result.iterations, 0);
+    EXPECT_NE(result.bestAction, nullptr);
+}
+
+TEST(mcts_test, actor_cannot_act){
+    auto env = createEnv();
+    env->team1->chasers[2]->isFined = true;
+    gameController::Mcts engine(gameController::scoreEvaluation(), -1, 1,
+                                createOptions(1, gameController::Mcts::Parallelism::Tree));
+    auto result = engine.search(env, {ID::LEFT_CHASER3, ID::RIGHT_CHASER2}, {100, std::chrono::hours(1)});
+    EXPECT_EQ(result.bestAction, nullptr);
+}
+
+TEST(mcts_test, invalid_arguments){
+    EXPECT_THROW(gameController::Mcts(gameController::scoreEvaluation(), 1, -1, {}), std::invalid_argument);
+    gameController::Mcts::Options options;
+    options.threads = 0;
+    EXPECT_THROW(gameController::Mcts(gameController::scoreEvaluation(), -1, 1, options), std::invalid_argument);
+    gameController::Mcts engine(gameController::scoreEvaluation(), -1, 1, {});
+    EXPECT_THROW(engine.search(createEnv(), {}), std::invalid_argument);
+    EXPECT_THROW(engine.search(createEnv(), {ID::QUAFFLE}), std::invalid_argument);
+
+    auto env = createEnv();
+    for (std::size_t i = 0; i <= gameModel::CompactEnvironment::MAX_CUBES; i++) {
+        env->pileOfShit.emplace_back(std::make_shared<gameModel::CubeOfShit>(gameModel::Position{8, 1}));
+    }
+
+    EXPECT_THROW(engine.search(env, {ID::LEFT_CHASER3}), std::invalid_argument);
+}
+
+TEST(mcts_test, clones_from_thread_arena){
+    gameController::Mcts engine(gameController::scoreEvaluation(), -1, 1,
+                                createOptions(1, gameController::Mcts::Parallelism::Tree));
+    gameModel::ScopedCloneResource scope(*std::pmr::null_memory_resource());
+    EXPECT_NO_THROW(engine.search(createEnv(), {ID::LEFT_CHASER3, ID::RIGHT_CHASER2}, {100, std::chrono::hours(1)}));
+}
@@ -3,10 +3,12 @@
 //
 
 #include <gtest/gtest.h>
+#include <unordered_set>
 #include <gmock/gmock-matchers.h>
 #include <Interference.h>
 #include "GameModel.h"
 #include "GameController.h"
+#include "Action.h"
 #include "setup.h"
 #include "SharedPtrSerialization.h"
 
@@ -39,6 +41,32 @@ TEST(env_test, getCell){
     EXPECT_EQ(gameModel::Environment::getCell(-1, 4), gameModel::Cell::OutOfBounds);
 }
 
+TEST(env_test, getCell_bounds){
+    using env = gameModel::Environment;
+    EXPECT_EQ(env::getCell(17, 6), gameModel::Cell::OutOfBounds);
+    EXPECT_EQ(env::getCell(8, 13), gameModel::Cell::OutOfBounds);
+    EXPECT_EQ(env::getCell(0, 0), gameModel::Cell::OutOfBounds);
+    EXPECT_EQ(env::getCell(16, 12), gameModel::Cell::OutOfBounds);
+    EXPECT_EQ(env::getCell(std::numeric_limits<int>::max(), 0), gameModel::Cell::OutOfBounds);
+    EXPECT_EQ(env::getCell(0, std::numeric_limits<int>::min()), gameModel::Cell::OutOfBounds);
+    EXPECT_EQ(env::getCell(2, 4), gameModel::Cell::GoalLeft);
+    EXPECT_EQ(env::getCell(14, 8), gameModel::Cell::GoalRight);
+}
+
+TEST(env_test, getAllValidCells){
+    using env = gameModel::Environment;
+    int goals = 0;
+    for(const auto &cell : env::getAllValidCells()){
+        EXPECT_NE(env::getCell(cell), gameModel::Cell::OutOfBounds);
+        if(env::isGoalCell(cell)){
+            goals++;
+        }
+    }
+
+    EXPECT_EQ(goals, 6);
+    EXPECT_FALSE(env::isGoalCell({3, 4}));
+}
+
 TEST(env_test, cellIsFree0){
     auto env = setup::createEnv();
 
@@ -222,6 +250,36 @@ TEST(env_test, getAllPlayerFreeCellsAround) {
     EXPECT_EQ(freeCells[6], gameModel::Position(11, 12));
 }
 
+TEST(env_test, getOccupancy) {
+    auto env = setup::createEnv();
+    env->snitch->exists = true;
+    env->snitch->position = {11, 2};
+    env->bludgers[0]->position = {6, 9};
+    env->team2->seeker->isFined = true;
+    env->pileOfShit.emplace_back(std::make_shared<gameModel::CubeOfShit>(gameModel::Position{5, 6}));
+
+    auto occupancy = env->getOccupancy();
+    EXPECT_TRUE(occupancy.leftPlayers[gameModel::cellIndex(2, 10)]);
+    EXPECT_FALSE(occupancy.rightPlayers[gameModel::cellIndex(2, 10)]);
+    EXPECT_TRUE(occupancy.rightPlayers[gameModel::cellIndex(13, 12)]);
+    EXPECT_FALSE(occupancy.rightPlayers[gameModel::cellIndex(11, 8)]);
+    EXPECT_TRUE(occupancy.balls[gameModel::cellIndex(11, 2)]);
+    EXPECT_TRUE(occupancy.balls[gameModel::cellIndex(6, 9)]);
+    EXPECT_TRUE(occupancy.balls[gameModel::cellIndex(8, 6)]);
+    EXPECT_TRUE(occupancy.blocked[gameModel::cellIndex(5, 6)]);
+    EXPECT_EQ(occupancy.blocked.count(), 1);
+
+    std::vector<gameModel::Position> expected;
+    for (const auto &cell : gameModel::Environment::getAllValidCells()) {
+        if (env->cellIsFree(cell)) {
+            expected.emplace_back(cell);
+        }
+    }
+
+    EXPECT_EQ(env->getAllFreeCells(), expected);
+    EXPECT_EQ(occupancy.free().count(), expected.size());
+}
+
 TEST(env_test, isShitOnCell){
     auto env = setup::createEnv();
     gameController::BlockCell testShit(env, env->team1, gameModel::Position(5,6));
@@ -259,6 +317,21 @@ TEST(env_test, removeDeprecatedShit){
     EXPECT_TRUE(env->pileOfShit.empty());
 }
 
+TEST(env_test, removeDeprecatedShit_mixed){
+    auto env = setup::createEnv();
+    for (int x = 10; x < 14; x++) {
+        env->pileOfShit.emplace_back(std::make_shared<gameModel::CubeOfShit>(gameModel::Position{x, 5}));
+        env->pileOfShit.back()->spawnedThisRound = x % 2 == 0;
+    }
+
+    env->removeDeprecatedShit();
+    ASSERT_EQ(env->pileOfShit.size(), 2);
+    EXPECT_EQ(env->pileOfShit[0]->position, gameModel::Position(10, 5));
+    EXPECT_EQ(env->pileOfShit[1]->position, gameModel::Position(12, 5));
+    EXPECT_FALSE(env->pileOfShit[0]->spawnedThisRound);
+    EXPECT_FALSE(env->pileOfShit[1]->spawnedThisRound);
+}
+
 TEST(env_test, clone_identical){
     using B = communication::messages::types::Broom;
     std::map<B, double> brooms;
@@ -292,6 +365,108 @@ TEST(env_test, clone){
     EXPECT_TRUE(originalEnv->pileOfShit.empty());
 }
 
+TEST(env_test, clone_resource){
+    auto originalEnv = setup::createEnv();
+    originalEnv->pileOfShit.emplace_back(std::make_shared<gameModel::CubeOfShit>(gameModel::Position{11, 5}));
+    alignas(std::max_align_t) static std::array<std::byte, 1 << 14> buffer;
+    std::pmr::monotonic_buffer_resource arena(buffer.data(), buffer.size(), std::pmr::null_memory_resource());
+    auto inArena = [](const void *object) {
+        auto address = static_cast<const std::byte *>(object);
+        return address >= buffer.data() && address < buffer.data() + buffer.size();
+    };
+
+    auto newEnv = originalEnv->clone(&arena);
+    EXPECT_EQ(*originalEnv, *newEnv);
+    EXPECT_TRUE(inArena(newEnv.get()));
+    EXPECT_TRUE(inArena(newEnv->team2->chasers[2].get()));
+    EXPECT_TRUE(inArena(newEnv->pileOfShit.front().get()));
+    newEnv.reset();
+
+    {
+        gameModel::ScopedCloneResource scope(arena);
+        EXPECT_EQ(gameModel::getCloneResource(), &arena);
+        newEnv = originalEnv->clone();
+        EXPECT_TRUE(inArena(newEnv->snitch.get()));
+        newEnv.reset();
+    }
+
+    EXPECT_EQ(gameModel::getCloneResource(), std::pmr::get_default_resource());
+    EXPECT_FALSE(inArena(originalEnv->clone()->quaffle.get()));
+}
+
+TEST(env_test, fork){
+    using Id = communication::messages::types::EntityId;
+    auto env = setup::createEnv();
+    env->pileOfShit.emplace_back(std::make_shared<gameModel::CubeOfShit>(gameModel::Position{11, 5}));
+    auto original = env->clone();
+    auto forked = env->fork([](gameModel::Environment &newEnv){
+        newEnv.mutablePlayer(Id::RIGHT_CHASER2)->position = {3, 3};
+        newEnv.mutableBall(Id::BLUDGER2)->position = {4, 4};
+        newEnv.mutableTeam(gameModel::TeamSide::LEFT)->score = 10;
+        newEnv.removeShitOnCell({11, 5});
+
+        const auto *player = newEnv.mutablePlayer(Id::RIGHT_CHASER2).get();
+        EXPECT_EQ(newEnv.mutablePlayer(Id::RIGHT_CHASER2).get(), player);
+        EXPECT_THROW(newEnv.mutablePlayer(Id::QUAFFLE), std::runtime_error);
+        EXPECT_THROW(newEnv.mutableBall(Id::LEFT_SEEKER), std::runtime_error);
+    });
+
+    EXPECT_EQ(*env, *original);
+    EXPECT_EQ(env->pileOfShit.size(), 1);
+    EXPECT_TRUE(forked->pileOfShit.empty());
+    EXPECT_EQ(forked->team2->chasers[1]->position, gameModel::Position(3, 3));
+    EXPECT_EQ(forked->bludgers[1]->position, gameModel::Position(4, 4));
+    EXPECT_EQ(forked->team1->score, 10);
+    EXPECT_EQ(forked->team2->chasers[0], env->team2->chasers[0]);
+    EXPECT_EQ(forked->team1->seeker, env->team1->seeker);
+    EXPECT_EQ(forked->bludgers[0], env->bludgers[0]);
+    EXPECT_EQ(forked->quaffle, env->quaffle);
+
+    auto unchanged = env->fork([](gameModel::Environment &){});
+    EXPECT_EQ(unchanged->team1, env->team1);
+    EXPECT_EQ(*unchanged, *env);
+
+    auto copy = forked->clone();
+    EXPECT_NE(copy->team1->seeker, env->team1->seeker);
+    copy->team1->seeker->position = {1, 1};
+    EXPECT_EQ(*env, *original);
+}
+
+TEST(env_test, getPlayerById){
+    using Id = communication::messages::types::EntityId;
+    auto env = setup::createEnv();
+    for (const auto &player : env->getAllPlayers()) {
+        EXPECT_EQ(env->getPlayerById(player->getId()), player);
+        EXPECT_EQ(&env->getPlayerRef(player->getId()), player.get());
+    }
+
+    EXPECT_EQ(env->team1->getPlayerByID(Id::LEFT_BEATER2).value(), env->team1->beaters[1]);
+    EXPECT_FALSE(env->team1->getPlayerByID(Id::RIGHT_BEATER2).has_value());
+    EXPECT_FALSE(env->team1->getPlayerByID(Id::QUAFFLE).has_value());
+    EXPECT_THROW(env->getPlayerById(Id::SNITCH), std::runtime_error);
+    EXPECT_THROW(env->getPlayerRef(Id::LEFT_WOMBAT), std::runtime_error);
+
+    std::swap(env->team2->chasers[0], env->team2->chasers[2]);
+    EXPECT_EQ(env->getPlayerById(Id::RIGHT_CHASER1), env->team2->chasers[2]);
+    std::swap(env->team1, env->team2);
+    EXPECT_EQ(env->getPlayerById(Id::RIGHT_CHASER3), env->team1->chasers[0]);
+    EXPECT_EQ(env->getPlayerById(Id::LEFT_SEEKER), env->team2->seeker);
+}
+
+TEST(env_test, getBallByID){
+    using Id = communication::messages::types::EntityId;
+    auto env = setup::createEnv();
+    EXPECT_EQ(env->getBallByID(Id::QUAFFLE), env->quaffle);
+    EXPECT_EQ(env->getBallByID(Id::SNITCH), env->snitch);
+    EXPECT_EQ(env->getBallByID(Id::BLUDGER1), env->bludgers[0]);
+    EXPECT_EQ(&env->getBallRef(Id::BLUDGER2), env->bludgers[1].get());
+    EXPECT_THROW(env->getBallByID(Id::LEFT_KEEPER), std::runtime_error);
+
+    std::swap(env->bludgers[0], env->bludgers[1]);
+    EXPECT_EQ(env->getBallByID(Id::BLUDGER1), env->bludgers[1]);
+    EXPECT_EQ(&env->getBallRef(Id::BLUDGER2), env->bludgers[0].get());
+}
+
 TEST(env_test, legalCells){
     auto env = setup::createEnv();
     env->pileOfShit.emplace_back(std::make_shared<gameModel::CubeOfShit>(gameModel::Position{1, 6}));
@@ -436,6 +611,172 @@ TEST(fanblock_test, banFan_and_getUses_and_getBannedCount) {
     EXPECT_EQ(env->team1->fanblock.getUses(gameModel::InterferenceType::Impulse), 1);
 }
 
+TEST(config_test, getExtraTurnProb) {
+    using B = communication::messages::types::Broom;
+    gameModel::Config config{10, {}, {}, {{B::FIREBOLT, 0.5}, {B::COMET260, 0.25}}};
+    EXPECT_EQ(config.getExtraTurnProb(B::FIREBOLT), 0.5);
+    EXPECT_EQ(config.getExtraTurnProb(B::COMET260), 0.25);
+    EXPECT_THROW(config.getExtraTurnProb(B::NIMBUS2001), std::out_of_range);
+    EXPECT_NE(config, (gameModel::Config{10, {}, {}, {{B::FIREBOLT, 0.5}, {B::COMET260, 0.25}, {B::NIMBUS2001, 0}}}));
+    EXPECT_EQ(config, (gameModel::Config{10, {}, {}, {{B::COMET260, 0.25}, {B::FIREBOLT, 0.5}}}));
+}
+
+TEST(config_test, probability_tables) {
+    auto config = setup::createConfig(10, {}, {0.8, 0, 0, 0.3, 0});
+    for (int distance = 0; distance <= gameModel::Config::MAX_THROW_DISTANCE + 2; distance++) {
+        EXPECT_DOUBLE_EQ(config.getThrowSuccessProb(distance), std::pow(0.8, distance));
+    }
+
+    for (std::size_t n = 0; n <= gameModel::Config::MAX_INTERCEPTORS + 2; n++) {
+        EXPECT_DOUBLE_EQ(config.getNoInterceptionProb(n), std::pow(0.7, n));
+    }
+
+    nlohmann::json json = config;
+    auto fromJson = json.get<gameModel::Config>();
+    EXPECT_DOUBLE_EQ(fromJson.getThrowSuccessProb(5), std::pow(0.8, 5));
+    EXPECT_DOUBLE_EQ(fromJson.getNoInterceptionProb(3), std::pow(0.7, 3));
+
+    gameModel::Config defaultConfig;
+    EXPECT_DOUBLE_EQ(defaultConfig.getThrowSuccessProb(0), 1);
+    EXPECT_DOUBLE_EQ(defaultConfig.getNoInterceptionProb(0), 1);
+    EXPECT_DOUBLE_EQ(defaultConfig.getThrowSuccessProb(3),
+                     std::pow(defaultConfig.getGameDynamicsProbs().throwSuccess, 3));
+    EXPECT_DOUBLE_EQ(defaultConfig.getNoInterceptionProb(3),
+                     std::pow(1 - defaultConfig.getGameDynamicsProbs().catchQuaffle, 3));
+}
+
+TEST(player_test, getRole) {
+    auto env = setup::createEnv();
+    using Role = gameModel::PlayerRole;
+    EXPECT_EQ(env->team1->seeker->getRole(), Role::Seeker);
+    EXPECT_EQ(env->team1->keeper->getRole(), Role::Keeper);
+    EXPECT_EQ(env->team2->beaters[1]->getRole(), Role::Beater);
+    EXPECT_EQ(env->team2->chasers[2]->getRole(), Role::Chaser);
+    EXPECT_TRUE(env->team1->keeper->canHoldQuaffle());
+    EXPECT_TRUE(env->team2->chasers[0]->canHoldQuaffle());
+    EXPECT_FALSE(env->team1->seeker->canHoldQuaffle());
+    EXPECT_FALSE(env->team1->beaters[0]->canHoldQuaffle());
+
+    nlohmann::json json = env->team2->keeper;
+    EXPECT_EQ(json.get<std::shared_ptr<gameModel::Keeper>>()->getRole(), Role::Keeper);
+    EXPECT_EQ(env->clone()->team1->beaters[0]->getRole(), Role::Beater);
+}
+
+TEST(env_test, getHash) {
+    auto env = setup::createEnv();
+    auto hash = env->getHash();
+    EXPECT_EQ(env->clone()->getHash(), hash);
+
+    auto changed = env->clone();
+    changed->team1->chasers[0]->position = {3, 10};
+    EXPECT_NE(changed->getHash(), hash);
+    changed->team1->chasers[0]->position = {2, 10};
+    EXPECT_EQ(changed->getHash(), hash);
+
+    changed->team2->keeper->knockedOut = true;
+    EXPECT_NE(changed->getHash(), hash);
+    changed->team2->keeper->knockedOut = false;
+    changed->team2->keeper->isFined = true;
+    EXPECT_NE(changed->getHash(), hash);
+    changed->team2->keeper->isFined = false;
+
+    changed->snitch->exists = true;
+    EXPECT_NE(changed->getHash(), hash);
+    changed->snitch->exists = false;
+
+    changed->team1->score = 10;
+    EXPECT_NE(changed->getHash(), hash);
+    changed->team1->score = 0;
+
+    changed->team2->fanblock.banFan(gameModel::InterferenceType::Impulse);
+    EXPECT_NE(changed->getHash(), hash);
+
+    auto withShit = env->clone();
+    withShit->pileOfShit.emplace_back(std::make_shared<gameModel::CubeOfShit>(gameModel::Position{5, 6}));
+    EXPECT_NE(withShit->getHash(), hash);
+    withShit->pileOfShit.back()->spawnedThisRound = false;
+    EXPECT_NE(withShit->getHash(), hash);
+
+    std::unordered_set<gameModel::Environment> states{*env, *env->clone(), *withShit};
+    EXPECT_EQ(states.size(), 2);
+}
+
+TEST(env_test, getHash_stacked_cubes) {
+    auto env = setup::createEnv();
+    auto hash = env->getHash();
+    auto stacked = env->clone();
+    stacked->pileOfShit.emplace_back(std::make_shared<gameModel::CubeOfShit>(gameModel::Position{5, 6}));
+    auto single = stacked->getHash();
+    stacked->pileOfShit.emplace_back(std::make_shared<gameModel::CubeOfShit>(gameModel::Position{5, 6}));
+    EXPECT_NE(stacked->getHash(), hash);
+    EXPECT_NE(stacked->getHash(), single);
+
+    stacked->pileOfShit.emplace_back(std::make_shared<gameModel::CubeOfShit>(gameModel::Position{5, 6}));
+    stacked->pileOfShit.back()->spawnedThisRound = false;
+    auto mixed = stacked->getHash();
+    stacked->pileOfShit.emplace_front(stacked->pileOfShit.back());
+    stacked->pileOfShit.pop_back();
+    EXPECT_EQ(stacked->getHash(), mixed);
+}
+
+//-------------------------------------CompactEnvironment---------------------------------------------------------------
+
+TEST(compact_env_test, toEnvironment){
+    auto env = setup::createEnv();
+    env->team1->score = 40;
+    env->team2->fanblock.banFan(gameModel::InterferenceType::Teleport);
+    env->team2->chasers[1]->isFined = true;
+    env->team1->seeker->knockedOut = true;
+    env->snitch->exists = true;
+    env->quaffle->position = {2, 10};
+    env->pileOfShit.emplace_back(std::make_shared<gameModel::CubeOfShit>(gameModel::Position{5, 6}));
+    env->pileOfShit.back()->spawnedThisRound = false;
+
+    gameModel::CompactEnvironment compact(*env);
+    EXPECT_EQ(*compact.toEnvironment(env->config), *env);
+    EXPECT_EQ(gameModel::CompactEnvironment(*compact.toEnvironment(env->config)), compact);
+}
+
+TEST(compact_env_test, applyTo){
+    auto env = setup::createEnv();
+    auto original = env->clone();
+    gameModel::CompactEnvironment compact(*env);
+
+    env->team1->chasers[0]->position = {3, 10};
+    env->team1->score = 10;
+    env->team1->fanblock.banFan(gameModel::InterferenceType::BlockCell);
+    env->pileOfShit.emplace_back(std::make_shared<gameModel::CubeOfShit>(gameModel::Position{5, 6}));
+    auto chaser = env->team1->chasers[0];
+    EXPECT_NE(gameModel::CompactEnvironment(*env), compact);
+
+    compact.applyTo(*env);
+    EXPECT_EQ(*env, *original);
+    EXPECT_EQ(env->team1->chasers[0], chaser);
+}
+
+TEST(compact_env_test, applyTo_run_action){
+    auto env = setup::createEnv();
+    const gameModel::CompactEnvironment state(*env);
+    gameController::Move move(env, env->team1->chasers[0], {3, 10});
+
+    state.applyTo(*env);
+    move.execute();
+    gameModel::CompactEnvironment result(*env);
+    EXPECT_EQ(result.team1.players[4].position, (gameModel::CompactEnvironment::CellPosition{3, 10}));
+
+    state.applyTo(*env);
+    EXPECT_EQ(gameModel::CompactEnvironment(*env), state);
+}
+
+TEST(compact_env_test, too_many_cubes){
+    auto env = setup::createEnv();
+    for(std::size_t i = 0; i <= gameModel::CompactEnvironment::MAX_CUBES; i++){
+        env->pileOfShit.emplace_back(std::make_shared<gameModel::CubeOfShit>(gameModel::Position{5, 6}));
+    }
+
+    EXPECT_THROW(gameModel::CompactEnvironment{*env}, std::invalid_argument);
+}
+
 //-------------------------------------Env serialization----------------------------------------------------------------
 
 TEST(env_test, serialize_and_deserialize){
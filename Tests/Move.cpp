@@ -523,3 +523,96 @@ TEST(move_test, move_execute_all_charge_goal_with_defender){
     EXPECT_EQ(env->team2->keeper->position, target);
     EXPECT_EQ(env->quaffle->position, env->team1->chasers[2]->position);
 }
+
+TEST(move_test, move_apply_undo){
+    auto env = setup::createEnv({0, {1, 0.4, 1, 0.5, 1, 1, 1, 1, 1, 1}, {1, 1, 0.8, 1, 1}, {}});
+    env->quaffle->position = env->team1->chasers[2]->position;
+    env->pileOfShit.emplace_back(std::make_shared<gameModel::CubeOfShit>(gameModel::Position{4, 4}));
+    env->pileOfShit.emplace_back(std::make_shared<gameModel::CubeOfShit>(gameModel::Position{9, 6}));
+    env->pileOfShit.emplace_back(std::make_shared<gameModel::CubeOfShit>(gameModel::Position{11, 7}));
+    auto original = env->clone();
+    gameController::Move move(env, env->team2->seeker, env->team1->chasers[2]->position);
+    auto resList = move.executeAll();
+    auto outcomes = move.getOutcomes();
+    ASSERT_EQ(outcomes.size(), resList.size());
+
+    for(std::size_t i = 0; i < outcomes.size(); i++){
+        EXPECT_DOUBLE_EQ(outcomes[i].probability, resList[i].second);
+        move.apply(outcomes[i]);
+        EXPECT_EQ(*env, *resList[i].first);
+        move.undo();
+        EXPECT_EQ(*env, *original);
+    }
+}
+
+TEST(move_test, move_update_hash){
+    auto env = setup::createEnv({0, {1, 0.4, 1, 0.5, 1, 1, 1, 1, 1, 1}, {1, 1, 0.8, 1, 1}, {}});
+    env->quaffle->position = env->team1->chasers[2]->position;
+    env->pileOfShit.emplace_back(std::make_shared<gameModel::CubeOfShit>(gameModel::Position{9, 6}));
+    const auto hash = env->getHash();
+    gameController::Move move(env, env->team2->seeker, env->team1->chasers[2]->position);
+    for(const auto &outcome : move.getOutcomes()){
+        auto record = gameController::applyOutcome(env, outcome);
+        EXPECT_EQ(gameController::updateHash(hash, *env, record), env->getHash());
+        gameController::undoOutcome(env, record);
+        EXPECT_EQ(env->getHash(), hash);
+    }
+}
+
+TEST(move_test, move_apply_twice){
+    auto env = setup::createEnv();
+    gameController::Move move(env, env->team2->seeker, gameModel::Position{12, 9});
+    EXPECT_THROW(move.undo(), std::runtime_error);
+    move.apply(0);
+    EXPECT_EQ(env->team2->seeker->position, gameModel::Position(12, 9));
+    EXPECT_THROW(move.apply(0), std::runtime_error);
+    move.undo();
+    EXPECT_EQ(env->team2->seeker->position, gameModel::Position(11, 8));
+}
+
+TEST(move_test, outcome_distribution_merges_same_effect){
+    using ID = communication::messages::types::EntityId;
+    gameController::ActionOutcome a;
+    a.probability = 0.25;
+    a.addMove(ID::LEFT_SEEKER, {3, 4});
+    a.addMove(ID::QUAFFLE, {3, 5});
+    a.clearCell({3, 5});
+    gameController::ActionOutcome b;
+    b.probability = 0.5;
+    b.addMove(ID::QUAFFLE, {3, 5});
+    b.addMove(ID::LEFT_SEEKER, {3, 4});
+    b.clearCell({3, 5});
+    auto c = b;
+    c.fined = ID::LEFT_SEEKER;
+
+    EXPECT_TRUE(a.hasSameEffect(b));
+    EXPECT_EQ(a.getEffectHash(), b.getEffectHash());
+    EXPECT_FALSE(a.hasSameEffect(c));
+
+    gameController::OutcomeDistribution distribution;
+    distribution.add(a);
+    distribution.add(c);
+    distribution.add(b);
+    ASSERT_EQ(distribution.size(), 2);
+    EXPECT_DOUBLE_EQ(distribution[0].probability, 0.75);
+    EXPECT_DOUBLE_EQ(distribution[1].probability, 0.5);
+    auto outcomes = distribution.release();
+    EXPECT_EQ(outcomes.size(), 2);
+    EXPECT_EQ(distribution.size(), 0);
+}
+
+TEST(move_test, move_outcomes_distinct){
+    auto env = setup::createEnv();
+    env->quaffle->position = env->team1->chasers[2]->position;
+    gameController::Move move(env, env->team2->seeker, env->team1->chasers[2]->position);
+    auto outcomes = move.getOutcomes();
+    double sum = 0;
+    for(std::size_t i = 0; i < outcomes.size(); i++){
+        sum += outcomes[i].probability;
+        for(std::size_t j = i + 1; j < outcomes.size(); j++){
+            EXPECT_FALSE(outcomes[i].hasSameEffect(outcomes[j]));
+        }
+    }
+
+    EXPECT_NEAR(sum, 1, 0.0000001);
+}
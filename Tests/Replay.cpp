@@ -0,0 +1,97 @@
+#include <gtest/gtest.h>
+#include <fstream>
+#include "Replay.h"
+#include "SharedPtrSerialization.h"
+#include "setup.h"
+
+namespace {
+    auto createStates(std::size_t count) -> std::vector<std::shared_ptr<gameModel::Environment>> {
+        std::vector<std::shared_ptr<gameModel::Environment>> ret{
+                setup::createEnv(setup::createConfig(30, {0.1, 0.2, 0.3, 0.4, 0.5, 0.6, 0.7, 0.8, 0.9, 0.15},
+                                                     {0.25, 0.35, 0.45, 0.55, 0.65}))};
+        for (std::size_t i = 1; i < count; i++) {
+            auto env = ret.back()->clone();
+            auto player = env->getAllPlayers()[i % 14];
+            player->position = {static_cast<int>(i % gameModel::FIELD_WIDTH),
+                                static_cast<int>(i * 7 % gameModel::FIELD_HEIGHT)};
+            env->quaffle->position = player->position;
+            if (i % 5 == 0) {
+                env->pileOfShit.emplace_back(std::make_shared<gameModel::CubeOfShit>(env->bludgers[0]->position));
+            } else if (i % 7 == 0 && !env->pileOfShit.empty()) {
+                env->pileOfShit.pop_front();
+            }
+
+            env->team1->score = static_cast<int>(i / 10 * 10);
+            ret.emplace_back(env);
+        }
+
+        return ret;
+    }
+
+    void expectEqual(const gameModel::Environment &a, const gameModel::Environment &b) {
+        EXPECT_EQ(a, b);
+        EXPECT_EQ(a.config, b.config);
+        ASSERT_EQ(a.pileOfShit.size(), b.pileOfShit.size());
+        for (std::size_t i = 0; i < a.pileOfShit.size(); i++) {
+            EXPECT_EQ(*a.pileOfShit[i], *b.pileOfShit[i]);
+        }
+    }
+}
+
+TEST(replay_test, seek){
+    const auto path = testing::TempDir() + "replay_test_seek.bin";
+    auto states = createStates(50);
+    {
+        gameModel::ReplayWriter writer(path, 8);
+        for (const auto &state : states) {
+            writer.append(*state);
+        }
+
+        EXPECT_EQ(writer.frameCount(), states.size());
+    }
+
+    gameModel::ReplayReader reader(path);
+    ASSERT_EQ(reader.frameCount(), states.size());
+    EXPECT_EQ(reader.getKeyframeInterval(), 8);
+    for (auto frame : {49, 0, 7, 8, 9, 23, 48}) {
+        expectEqual(*reader.getFrame(frame), *states[frame]);
+    }
+
+    EXPECT_THROW(reader.getFrame(states.size()), std::out_of_range);
+}
+
+TEST(replay_test, smaller_than_json){
+    const auto path = testing::TempDir() + "replay_test_size.bin";
+    auto states = createStates(64);
+    std::size_t jsonSize = 0;
+    gameModel::ReplayWriter writer(path);
+    for (const auto &state : states) {
+        writer.append(*state);
+        jsonSize += nlohmann::json(state).dump().size();
+    }
+
+    writer.close();
+    EXPECT_THROW(writer.append(*states.front()), std::logic_error);
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    EXPECT_LT(static_cast<std::size_t>(file.tellg()) * 10, jsonSize);
+    EXPECT_EQ(gameModel::ReplayReader(path).frameCount(), states.size());
+}
+
+TEST(replay_test, invalid_file){
+    const auto path = testing::TempDir() + "replay_test_invalid.bin";
+    EXPECT_THROW(gameModel::ReplayReader(path + ".missing"), std::runtime_error);
+    EXPECT_THROW(gameModel::ReplayWriter(path, 0), std::invalid_argument);
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file << "QR this is not a replay at all";
+    }
+
+    EXPECT_THROW(gameModel::ReplayReader{path}, std::runtime_error);
+    {
+        gameModel::ReplayWriter writer(path);
+    }
+
+    gameModel::ReplayReader empty(path);
+    EXPECT_EQ(empty.frameCount(), 0);
+    EXPECT_THROW(empty.getFrame(0), std::out_of_range);
+}
@@ -0,0 +1,75 @@
+#include <gtest/gtest.h>
+#include <thread>
+#include "GameController.h"
+#include "setup.h"
+
+TEST(rng_test, same_seed_same_sequence){
+    gameController::Xoshiro256 a(42);
+    gameController::Xoshiro256 b(42);
+    gameController::Xoshiro256 c(43);
+    for (int i = 0; i < 100; i++) {
+        auto val = a();
+        EXPECT_EQ(val, b());
+        EXPECT_NE(val, c());
+    }
+
+    b.jump();
+    EXPECT_NE(a, b);
+}
+
+TEST(rng_test, seedRng){
+    std::vector<int> first;
+    gameController::seedRng(1337);
+    for (int i = 0; i < 100; i++) {
+        first.emplace_back(gameController::rng(0, 1000));
+    }
+
+    gameController::seedRng(1337);
+    for (int i = 0; i < 100; i++) {
+        EXPECT_EQ(gameController::rng(0, 1000), first[i]);
+    }
+}
+
+TEST(rng_test, scoped_rng){
+    gameController::seedRng(1);
+    auto threadEngine = gameController::getRng();
+    gameController::Xoshiro256 matchEngine(2);
+    {
+        gameController::ScopedRng scope(matchEngine);
+        EXPECT_EQ(&gameController::getRng(), &matchEngine);
+        gameController::rng(0.0, 1.0);
+        EXPECT_NE(matchEngine, gameController::Xoshiro256(2));
+    }
+
+    EXPECT_EQ(gameController::getRng(), threadEngine);
+}
+
+TEST(rng_test, engine_per_thread){
+    gameController::seedRng(5);
+    auto before = gameController::getRng();
+    std::thread worker([] {
+        gameController::seedRng(6);
+        gameController::rng(0, 10);
+    });
+    worker.join();
+    EXPECT_EQ(gameController::getRng(), before);
+}
+
+TEST(rng_test, reproducible_bludger_move){
+    auto env = setup::createEnv();
+    env->team1->chasers[0]->position = {2, 10};
+    std::vector<gameModel::Position> positions;
+    gameController::seedRng(7);
+    for (int i = 0; i < 20; i++) {
+        auto clone = env->clone();
+        gameController::moveBludger(clone->bludgers[0], clone);
+        positions.emplace_back(clone->bludgers[0]->position);
+    }
+
+    gameController::seedRng(7);
+    for (const auto &pos : positions) {
+        auto clone = env->clone();
+        gameController::moveBludger(clone->bludgers[0], clone);
+        EXPECT_EQ(clone->bludgers[0]->position, pos);
+    }
+}
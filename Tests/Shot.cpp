@@ -609,3 +609,183 @@ TEST(shot_test, shot_test_get_all_landing_cells_Test2){
                                                        gameModel::Position(13, 5), gameModel::Position(14, 5), gameModel::Position(15, 5), gameModel::Position(16, 5)));
 }
 
+TEST(shot_test, apply_undo_long_shot_intercept){
+    auto env = setup::createEnv({0, {}, {0.5, 0, 0, 0.4, 0}, {}});
+    env->quaffle->position = env->team1->chasers[2]->position;
+    env->team2->seeker->position = {7, 7};
+    env->pileOfShit.emplace_back(std::make_shared<gameModel::CubeOfShit>(gameModel::Position{3, 7}));
+    auto original = env->clone();
+    gameController::Shot shot(env, env->team1->chasers[2], env->quaffle, gameModel::Position{2, 7});
+    auto resList = shot.executeAll();
+    ASSERT_EQ(resList.size(), 30);
+
+    for(std::size_t i = 0; i < resList.size(); i++){
+        shot.apply(i);
+        EXPECT_EQ(*env, *resList[i].first);
+        shot.undo();
+        EXPECT_EQ(*env, *original);
+    }
+}
+
+TEST(shot_test, enumerate_outcomes){
+    auto env = setup::createEnv({0, {}, {0.5, 0, 0, 0.4, 0}, {}});
+    env->quaffle->position = env->team1->chasers[2]->position;
+    env->team2->seeker->position = {7, 7};
+    gameController::Shot shot(env, env->team1->chasers[2], env->quaffle, gameModel::Position{2, 7});
+    auto resList = shot.executeAll();
+
+    auto outcomes = shot.enumerateOutcomes();
+    EXPECT_EQ(outcomes.size(), resList.size());
+    EXPECT_NEAR(outcomes.remainingProbability(), 1, 0.0000001);
+    EXPECT_THROW(outcomes.current(), std::out_of_range);
+    std::size_t i = 0;
+    while(outcomes.next()){
+        EXPECT_DOUBLE_EQ(outcomes.current().probability, resList[i].second);
+        EXPECT_EQ(*outcomes.materialize(), *resList[i].first);
+        i++;
+    }
+
+    EXPECT_EQ(i, resList.size());
+    EXPECT_DOUBLE_EQ(outcomes.remainingProbability(), 0);
+    EXPECT_FALSE(outcomes.next());
+}
+
+TEST(shot_test, enumerate_outcomes_most_likely_first){
+    auto env = setup::createEnv({0, {}, {0.5, 0, 0, 0.4, 0}, {}});
+    env->quaffle->position = env->team1->chasers[2]->position;
+    env->team2->seeker->position = {7, 7};
+    gameController::Shot shot(env, env->team1->chasers[2], env->quaffle, gameModel::Position{2, 7});
+
+    auto outcomes = shot.enumerateOutcomes(gameController::OutcomeEnumerator::Order::MostLikelyFirst);
+    double last = 1;
+    double visitedProb = 0;
+    std::size_t visited = 0;
+    while(outcomes.next()){
+        EXPECT_LE(outcomes.current().probability, last);
+        last = outcomes.current().probability;
+        visitedProb += last;
+        visited++;
+        EXPECT_NEAR(visitedProb + outcomes.remainingProbability(), 1, 0.0000001);
+        if(outcomes.remainingProbability() < 0.1){
+            break;
+        }
+    }
+
+    EXPECT_LT(visited, outcomes.size());
+    EXPECT_EQ(env->quaffle->position, env->team1->chasers[2]->position);
+}
+
+TEST(shot_test, execute_all_min_probability){
+    auto env = setup::createEnv({0, {}, {0.5, 0, 0, 0, 0}, {}});
+    env->quaffle->position = env->team1->chasers[2]->position;
+    gameController::Shot shot(env, env->team1->chasers[2], env->quaffle, gameModel::Position{10, 5});
+    double residual = 0;
+    auto resList = shot.executeAll({0.1, std::numeric_limits<std::size_t>::max(), false}, &residual);
+    ASSERT_EQ(resList.size(), 1);
+    EXPECT_EQ(resList[0].first->quaffle->position, gameModel::Position(10, 5));
+    EXPECT_DOUBLE_EQ(resList[0].second, shot.successProb());
+    EXPECT_NEAR(resList[0].second + residual, 1, 0.0000001);
+
+    resList = shot.executeAll({0.1}, &residual);
+    ASSERT_EQ(resList.size(), 1);
+    EXPECT_DOUBLE_EQ(resList[0].second, 1);
+    EXPECT_NEAR(residual, 1 - shot.successProb(), 0.0000001);
+    EXPECT_EQ(env->quaffle->position, env->team1->chasers[2]->position);
+}
+
+TEST(shot_test, execute_all_shared){
+    auto env = setup::createEnv({0, {}, {0.5, 0, 0, 0.4, 0}, {}});
+    env->quaffle->position = env->team1->chasers[2]->position;
+    env->team2->seeker->position = {7, 7};
+    env->pileOfShit.emplace_back(std::make_shared<gameModel::CubeOfShit>(gameModel::Position{3, 7}));
+    auto original = env->clone();
+    gameController::Shot shot(env, env->team1->chasers[2], env->quaffle, gameModel::Position{2, 7});
+    auto all = shot.executeAll();
+    auto shared = shot.executeAllShared();
+    ASSERT_EQ(shared.size(), all.size());
+    for (std::size_t i = 0; i < all.size(); i++) {
+        EXPECT_EQ(*shared[i].first, *all[i].first);
+        EXPECT_DOUBLE_EQ(shared[i].second, all[i].second);
+        EXPECT_EQ(shared[i].first->team1->seeker, env->team1->seeker);
+        EXPECT_EQ(shared[i].first->bludgers[0], env->bludgers[0]);
+        EXPECT_NE(shared[i].first->quaffle, env->quaffle);
+    }
+
+    EXPECT_EQ(*env, *original);
+    EXPECT_EQ(env->pileOfShit.size(), 1);
+}
+
+TEST(shot_test, update_hash_stacked_cubes){
+    auto env = setup::createEnv({0, {}, {0.5, 0, 0, 0.4, 0}, {}});
+    env->quaffle->position = env->team1->chasers[2]->position;
+    env->team2->seeker->position = {7, 7};
+    for (int i = 0; i < 2; i++) {
+        env->pileOfShit.emplace_back(std::make_shared<gameModel::CubeOfShit>(gameModel::Position{2, 7}));
+    }
+
+    env->pileOfShit.emplace_back(std::make_shared<gameModel::CubeOfShit>(gameModel::Position{2, 7}));
+    env->pileOfShit.back()->spawnedThisRound = false;
+    const auto hash = env->getHash();
+    gameController::Shot shot(env, env->team1->chasers[2], env->quaffle, gameModel::Position{2, 7});
+    bool clearedStack = false;
+    for (const auto &outcome : shot.getOutcomes()) {
+        auto record = gameController::applyOutcome(env, outcome);
+        clearedStack |= record.removedCubes.size() == 3;
+        EXPECT_EQ(gameController::updateHash(hash, *env, record), env->getHash());
+        gameController::undoOutcome(env, record);
+        EXPECT_EQ(env->getHash(), hash);
+    }
+
+    EXPECT_TRUE(clearedStack);
+}
+
+TEST(shot_test, execute_all_max_outcomes){
+    auto env = setup::createEnv({0, {}, {0.5, 0, 0, 0.4, 0}, {}});
+    env->quaffle->position = env->team1->chasers[2]->position;
+    env->team2->seeker->position = {7, 7};
+    gameController::Shot shot(env, env->team1->chasers[2], env->quaffle, gameModel::Position{2, 7});
+    auto all = shot.executeAll();
+    ASSERT_GT(all.size(), 3);
+
+    gameController::OutcomeFilter filter;
+    filter.maxOutcomes = 3;
+    filter.renormalise = false;
+    double residual = 0;
+    auto resList = shot.executeAll(filter, &residual);
+    ASSERT_EQ(resList.size(), 3);
+    double kept = 0;
+    for(const auto &res : resList){
+        kept += res.second;
+        EXPECT_LT(std::count_if(all.begin(), all.end(), [&res](const auto &other){
+            return other.second > res.second;
+        }), 3);
+    }
+
+    EXPECT_NEAR(kept + residual, 1, 0.0000001);
+
+    auto outcomes = shot.getOutcomes();
+    EXPECT_DOUBLE_EQ(gameController::filterOutcomes(outcomes, {}), 0);
+    EXPECT_EQ(outcomes.size(), all.size());
+}
+
+TEST(shot_test, execute_all_merges_catch_on_target){
+    auto env = setup::createEnv({0, {}, {0.5, 0, 0, 0.4, 0}, {}});
+    env->quaffle->position = env->team1->chasers[2]->position;
+    env->team2->keeper->position = {10, 5};
+    gameController::Shot shot(env, env->team1->chasers[2], env->quaffle, gameModel::Position{10, 5});
+    auto resList = shot.executeAll();
+    ASSERT_EQ(resList.size(), 9);
+    EXPECT_EQ(std::count_if(resList.begin(), resList.end(), [](const auto &res){
+        return res.first->quaffle->position == gameModel::Position(10, 5);
+    }), 1);
+
+    double sum = 0;
+    for(const auto &res : resList){
+        sum += res.second;
+        if(res.first->quaffle->position == gameModel::Position(10, 5)){
+            EXPECT_NEAR(res.second, 0.55, 0.0000001);
+        }
+    }
+
+    EXPECT_NEAR(sum, 1, 0.0000001);
+}
@@ -0,0 +1,66 @@
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+#include "TranspositionTable.h"
+#include "setup.h"
+
+TEST(transposition_table_test, store_and_probe){
+    gameController::TranspositionTable table(1000);
+    EXPECT_EQ(table.size(), 1024);
+
+    auto key = setup::createEnv()->getHash();
+    EXPECT_FALSE(table.probe(key).has_value());
+    EXPECT_TRUE(table.store(key, {0.25, gameController::Bound::Lower, 3, 7}));
+
+    auto entry = table.probe(key);
+    ASSERT_TRUE(entry.has_value());
+    EXPECT_DOUBLE_EQ(entry->value, 0.25);
+    EXPECT_EQ(entry->bound, gameController::Bound::Lower);
+    EXPECT_EQ(entry->depth, 3);
+    EXPECT_EQ(entry->bestAction, 7);
+
+    //same slot, different key
+    EXPECT_FALSE(table.probe(key + table.size()).has_value());
+
+    table.clear();
+    EXPECT_FALSE(table.probe(key).has_value());
+}
+
+TEST(transposition_table_test, replace_by_depth){
+    gameController::TranspositionTable table(16);
+    const std::uint64_t key = 5;
+    EXPECT_TRUE(table.store(key, {1, gameController::Bound::Exact, 4}));
+    EXPECT_FALSE(table.store(key + 16, {2, gameController::Bound::Exact, 3}));
+    EXPECT_DOUBLE_EQ(table.probe(key)->value, 1);
+    EXPECT_TRUE(table.store(key + 16, {2, gameController::Bound::Exact, 4}));
+    EXPECT_FALSE(table.probe(key).has_value());
+    EXPECT_DOUBLE_EQ(table.probe(key + 16)->value, 2);
+
+    table.newSearch();
+    EXPECT_TRUE(table.probe(key + 16).has_value());
+    EXPECT_TRUE(table.store(key, {3, gameController::Bound::Upper, 0}));
+    EXPECT_DOUBLE_EQ(table.probe(key)->value, 3);
+}
+
+TEST(transposition_table_test, concurrent_access){
+    gameController::TranspositionTable table(64);
+    std::vector<std::thread> threads;
+    for(unsigned int t = 0; t < 4; t++){
+        threads.emplace_back([&table, t](){
+            for(std::uint64_t i = 0; i < 100000; i++){
+                auto key = i * 0x9E3779B97F4A7C15ull + t;
+                table.store(key, {static_cast<double>(key % 1000), gameController::Bound::Exact,
+                                  static_cast<std::uint8_t>(key % 7)});
+                auto other = table.probe((i + 1) * 0x9E3779B97F4A7C15ull);
+                if(other.has_value()){
+                    //entries are never mixed up between keys
+                    EXPECT_DOUBLE_EQ(other->value, static_cast<double>(((i + 1) * 0x9E3779B97F4A7C15ull) % 1000));
+                }
+            }
+        });
+    }
+
+    for(auto &thread : threads){
+        thread.join();
+    }
+}
@@ -65,3 +65,21 @@ TEST(wrest_quaffel_test, wrest_execute3) {
     EXPECT_EQ(mvRes.first[0], gameController::ActionResult::WrestQuaffel);
 
 }
+
+TEST(wrest_quaffel_test, wrest_apply_undo) {
+    auto env = setup::createEnv({0, {1, 1, 1, 1, 1, 1, 1, 1, 1, 1}, {1, 1, 1, 1, 0.3}, {}});
+    env->quaffle->position = gameModel::Position(16, 4);
+    env->team1->keeper->position = env->quaffle->position;
+    env->team2->chasers[0]->position = gameModel::Position(16,5);
+    auto original = env->clone();
+
+    gameController::WrestQuaffle action(env, env->team2->chasers[0], env->team1->keeper->position);
+    auto outcomes = action.getOutcomes();
+    ASSERT_EQ(outcomes.size(), 2);
+    EXPECT_DOUBLE_EQ(outcomes[1].probability, 0.3);
+
+    action.apply(1);
+    EXPECT_EQ(env->quaffle->position, gameModel::Position(16,5));
+    action.undo();
+    EXPECT_EQ(*env, *original);
+}
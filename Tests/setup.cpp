@@ -4,6 +4,18 @@
 
 #include "setup.h"
 
+auto setup::createConfig(unsigned int maxRounds) -> gameModel::Config {
+    return createConfig(maxRounds, {0.5, 0.5, 0.5, 0.5, 0.5, 0.3, 0.3, 0.3, 0.3, 0.3}, {0.8, 0.4, 0.3, 0.6, 0.5});
+}
+
+auto setup::createConfig(unsigned int maxRounds, const gameModel::FoulDetectionProbs &foulDetectionProbs,
+                         const gameModel::GameDynamicsProbs &gameDynamicsProbs) -> gameModel::Config {
+    using B = communication::messages::types::Broom;
+    std::map<B, double> brooms{{B::TINDERBLAST, 0.1}, {B::CLEANSWEEP11, 0.2}, {B::COMET260, 0.3},
+                               {B::NIMBUS2001, 0.4}, {B::FIREBOLT, 0.5}};
+    return {maxRounds, foulDetectionProbs, gameDynamicsProbs, brooms};
+}
+
 auto setup::createEnv() -> std::shared_ptr<gameModel::Environment> {
     return createEnv({0, {}, {}, {}});
 }
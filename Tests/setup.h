@@ -7,6 +7,9 @@
 #ifndef SOPRAGAMELOGIC_SETUP_H
 #define SOPRAGAMELOGIC_SETUP_H
 namespace setup{
+    auto createConfig(unsigned int maxRounds = 30) -> gameModel::Config;
+    auto createConfig(unsigned int maxRounds, const gameModel::FoulDetectionProbs &foulDetectionProbs,
+                      const gameModel::GameDynamicsProbs &gameDynamicsProbs) -> gameModel::Config;
     auto createEnv() -> std::shared_ptr<gameModel::Environment>;
     auto createEnv(const gameModel::Config &config) -> std::shared_ptr<gameModel::Environment>;
 }
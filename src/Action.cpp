@@ -6,13 +6,56 @@
  */
 
 #include <utility>
+#include <algorithm>
+#include <numeric>
 #include "Action.h"
 #include "GameModel.h"
+#include "conversions.h"
 
-#define QUAFFLETHROW (((INSTANCE_OF(actor, gameModel::Chaser)) || (INSTANCE_OF(actor, gameModel::Keeper))) && (INSTANCE_OF(ball, gameModel::Quaffle)))
-#define BLUDGERSHOT ((INSTANCE_OF(actor, gameModel::Beater)) && (INSTANCE_OF(ball, gameModel::Bludger)))
+#define QUAFFLETHROW ((actor->canHoldQuaffle()) && (ball->getId() == communication::messages::types::EntityId::QUAFFLE))
+#define BLUDGERSHOT ((actor->getRole() == gameModel::PlayerRole::Beater) && \
+    (ball->getId() == communication::messages::types::EntityId::BLUDGER1 || ball->getId() == communication::messages::types::EntityId::BLUDGER2))
 
 namespace gameController{
+    namespace {
+        /**
+         * Applies an outcome to an Environment while it is forked (see Environment::fork), copying only the changed
+         * objects
+         * @param env the forked environment
+         * @param outcome the outcome to apply
+         */
+        void applyOutcomeCopyOnWrite(gameModel::Environment &env, const ActionOutcome &outcome) {
+            for(std::size_t i = 0; i < outcome.numberOfMoves; i++){
+                const auto &move = outcome.moves[i];
+                if(gameLogic::conversions::isBall(move.id)){
+                    env.mutableBall(move.id)->position = move.target;
+                } else {
+                    env.mutablePlayer(move.id)->position = move.target;
+                }
+            }
+
+            for(std::size_t i = 0; i < outcome.numberOfClearedCells; i++){
+                env.removeShitOnCell(outcome.clearedCells[i]);
+            }
+
+            if(outcome.knockedOut.has_value()){
+                env.mutablePlayer(outcome.knockedOut.value())->knockedOut = true;
+            }
+
+            if(outcome.fined.has_value()){
+                env.mutablePlayer(outcome.fined.value())->isFined = true;
+            }
+
+            if(outcome.scoreLeft != 0){
+                env.mutableTeam(gameModel::TeamSide::LEFT)->score += outcome.scoreLeft;
+            }
+
+            if(outcome.scoreRight != 0){
+                env.mutableTeam(gameModel::TeamSide::RIGHT)->score += outcome.scoreRight;
+            }
+        }
+    }
+
     Action::Action(std::shared_ptr<gameModel::Environment> env, std::shared_ptr<gameModel::Player> actor,
             gameModel::Position target) :  actor(std::move(actor)), env(std::move(env)), target(target){}
 
@@ -20,6 +63,411 @@ namespace gameController{
         return target;
     }
 
+    auto Action::executeAll() const -> std::vector<std::pair<std::shared_ptr<gameModel::Environment>, double>> {
+        return executeAll(OutcomeFilter{});
+    }
+
+    auto Action::executeAll(const OutcomeFilter &filter, double *residual) const ->
+        std::vector<std::pair<std::shared_ptr<gameModel::Environment>, double>> {
+        auto outcomes = getOutcomes();
+        auto dropped = filterOutcomes(outcomes, filter);
+        if(residual != nullptr){
+            *residual = dropped;
+        }
+
+        std::vector<std::pair<std::shared_ptr<gameModel::Environment>, double>> ret;
+        ret.reserve(outcomes.size());
+        for(const auto &outcome : outcomes){
+            auto newEnv = env->clone();
+            applyOutcome(newEnv, outcome);
+            ret.emplace_back(std::move(newEnv), outcome.probability);
+        }
+
+        return ret;
+    }
+
+    auto Action::executeAllShared(const OutcomeFilter &filter, double *residual) const ->
+        std::vector<std::pair<std::shared_ptr<const gameModel::Environment>, double>> {
+        auto outcomes = getOutcomes();
+        auto dropped = filterOutcomes(outcomes, filter);
+        if(residual != nullptr){
+            *residual = dropped;
+        }
+
+        std::vector<std::pair<std::shared_ptr<const gameModel::Environment>, double>> ret;
+        ret.reserve(outcomes.size());
+        for(const auto &outcome : outcomes){
+            ret.emplace_back(env->fork([&outcome](gameModel::Environment &newEnv){
+                applyOutcomeCopyOnWrite(newEnv, outcome);
+            }), outcome.probability);
+        }
+
+        return ret;
+    }
+
+    void Action::apply(std::size_t outcomeIndex) {
+        apply(getOutcomes().at(outcomeIndex));
+    }
+
+    void Action::apply(const ActionOutcome &outcome) {
+        if(undoRecord.has_value()){
+            throw std::runtime_error("Action is already applied");
+        }
+
+        undoRecord = applyOutcome(env, outcome);
+    }
+
+    void Action::undo() {
+        if(!undoRecord.has_value()){
+            throw std::runtime_error("Action is not applied");
+        }
+
+        undoOutcome(env, undoRecord.value());
+        undoRecord.reset();
+    }
+
+    auto Action::enumerateOutcomes(OutcomeEnumerator::Order order) const -> OutcomeEnumerator {
+        return {env, getOutcomes(), order};
+    }
+
+    OutcomeEnumerator::OutcomeEnumerator(std::shared_ptr<const gameModel::Environment> env, std::vector<ActionOutcome> outcomes,
+                                         Order order) : env(std::move(env)), outcomes(std::move(outcomes)) {
+        if(order == Order::MostLikelyFirst){
+            std::stable_sort(this->outcomes.begin(), this->outcomes.end(), [](const auto &a, const auto &b){
+                return a.probability > b.probability;
+            });
+        }
+
+        for(const auto &outcome : this->outcomes){
+            remaining += outcome.probability;
+        }
+    }
+
+    bool OutcomeEnumerator::next() {
+        if(visited == outcomes.size()){
+            return false;
+        }
+
+        remaining -= outcomes[visited++].probability;
+        if(visited == outcomes.size()){
+            //avoid rounding errors
+            remaining = 0;
+        }
+
+        return true;
+    }
+
+    auto OutcomeEnumerator::current() const -> const ActionOutcome & {
+        if(visited == 0){
+            throw std::out_of_range("next has not been called");
+        }
+
+        return outcomes[visited - 1];
+    }
+
+    auto OutcomeEnumerator::materialize() const -> std::shared_ptr<gameModel::Environment> {
+        auto newEnv = env->clone();
+        applyOutcome(newEnv, current());
+        return newEnv;
+    }
+
+    auto OutcomeEnumerator::remainingProbability() const -> double {
+        return remaining;
+    }
+
+    auto OutcomeEnumerator::size() const -> std::size_t {
+        return outcomes.size();
+    }
+
+    void ActionOutcome::addMove(communication::messages::types::EntityId id, const gameModel::Position &position) {
+        for(std::size_t i = 0; i < numberOfMoves; i++){
+            if(moves[i].id == id){
+                moves[i].target = position;
+                return;
+            }
+        }
+
+        if(numberOfMoves == MAX_MOVES){
+            throw std::runtime_error("Too many moves in outcome");
+        }
+
+        moves[numberOfMoves++] = {id, position};
+    }
+
+    auto ActionOutcome::getMove(communication::messages::types::EntityId id) const -> std::optional<gameModel::Position> {
+        for(std::size_t i = 0; i < numberOfMoves; i++){
+            if(moves[i].id == id){
+                return moves[i].target;
+            }
+        }
+
+        return std::nullopt;
+    }
+
+    void ActionOutcome::clearCell(const gameModel::Position &cell) {
+        for(std::size_t i = 0; i < numberOfClearedCells; i++){
+            if(clearedCells[i] == cell){
+                return;
+            }
+        }
+
+        if(numberOfClearedCells == MAX_CLEARED_CELLS){
+            throw std::runtime_error("Too many cleared cells in outcome");
+        }
+
+        clearedCells[numberOfClearedCells++] = cell;
+    }
+
+    void ActionOutcome::addScore(gameModel::TeamSide side, int points) {
+        if(side == gameModel::TeamSide::LEFT){
+            scoreLeft += points;
+        } else {
+            scoreRight += points;
+        }
+    }
+
+    bool ActionOutcome::hasSameEffect(const ActionOutcome &other) const {
+        if(numberOfMoves != other.numberOfMoves || numberOfClearedCells != other.numberOfClearedCells ||
+           knockedOut != other.knockedOut || fined != other.fined || scoreLeft != other.scoreLeft ||
+           scoreRight != other.scoreRight){
+            return false;
+        }
+
+        for(std::size_t i = 0; i < numberOfMoves; i++){
+            if(other.getMove(moves[i].id) != moves[i].target){
+                return false;
+            }
+        }
+
+        auto clearedEnd = other.clearedCells.begin() + other.numberOfClearedCells;
+        for(std::size_t i = 0; i < numberOfClearedCells; i++){
+            if(std::find(other.clearedCells.begin(), clearedEnd, clearedCells[i]) == clearedEnd){
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    auto ActionOutcome::getEffectHash() const -> std::uint64_t {
+        auto mix = [](std::uint64_t x){
+            x += 0x9E3779B97F4A7C15ull;
+            x = (x ^ (x >> 30u)) * 0xBF58476D1CE4E5B9ull;
+            x = (x ^ (x >> 27u)) * 0x94D049BB133111EBull;
+            return x ^ (x >> 31u);
+        };
+
+        auto pack = [](const gameModel::Position &position){
+            return static_cast<std::uint64_t>(static_cast<std::uint32_t>(position.x)) << 16u |
+                   static_cast<std::uint32_t>(position.y);
+        };
+
+        // order independent combination of moves and cleared cells
+        std::uint64_t hash = 0;
+        for(std::size_t i = 0; i < numberOfMoves; i++){
+            hash += mix(static_cast<std::uint64_t>(moves[i].id) << 40u | pack(moves[i].target));
+        }
+
+        for(std::size_t i = 0; i < numberOfClearedCells; i++){
+            hash += mix(1ull << 48u | pack(clearedCells[i]));
+        }
+
+        hash = mix(hash ^ (knockedOut.has_value() ? static_cast<std::uint64_t>(knockedOut.value()) + 1 : 0));
+        hash = mix(hash ^ (fined.has_value() ? static_cast<std::uint64_t>(fined.value()) + 1 : 0));
+        hash = mix(hash ^ static_cast<std::uint32_t>(scoreLeft));
+        return mix(hash ^ static_cast<std::uint32_t>(scoreRight));
+    }
+
+    void OutcomeDistribution::reserve(std::size_t capacity) {
+        outcomes.reserve(capacity);
+        index.reserve(capacity);
+    }
+
+    void OutcomeDistribution::add(const ActionOutcome &outcome) {
+        const auto hash = outcome.getEffectHash();
+        auto range = index.equal_range(hash);
+        for(auto it = range.first; it != range.second; it++){
+            auto &existing = outcomes[it->second];
+            if(existing.hasSameEffect(outcome)){
+                existing.probability += outcome.probability;
+                return;
+            }
+        }
+
+        index.emplace(hash, outcomes.size());
+        outcomes.emplace_back(outcome);
+    }
+
+    auto OutcomeDistribution::size() const -> std::size_t {
+        return outcomes.size();
+    }
+
+    auto OutcomeDistribution::operator[](std::size_t i) const -> const ActionOutcome & {
+        return outcomes[i];
+    }
+
+    auto OutcomeDistribution::release() -> std::vector<ActionOutcome> {
+        index.clear();
+        return std::move(outcomes);
+    }
+
+    namespace {
+        auto getObject(const gameModel::Environment &env, communication::messages::types::EntityId id) ->
+            gameModel::Object & {
+            if(gameLogic::conversions::isBall(id)){
+                return env.getBallRef(id);
+            }
+
+            return env.getPlayerRef(id);
+        }
+    }
+
+    auto applyOutcome(const std::shared_ptr<gameModel::Environment> &env, const ActionOutcome &outcome) -> UndoRecord {
+        UndoRecord record;
+        record.numberOfMoves = outcome.numberOfMoves;
+        for(std::size_t i = 0; i < outcome.numberOfMoves; i++){
+            auto &object = getObject(*env, outcome.moves[i].id);
+            record.oldPositions[i] = {outcome.moves[i].id, object.position};
+            object.position = outcome.moves[i].target;
+        }
+
+        for(std::size_t i = 0; i < outcome.numberOfClearedCells; i++){
+            auto &pile = env->pileOfShit;
+            for(auto it = pile.begin(); it != pile.end();){
+                if((*it)->position == outcome.clearedCells[i]){
+                    record.removedCubes.emplace_back(static_cast<std::size_t>(it - pile.begin()), *it);
+                    it = pile.erase(it);
+                } else {
+                    it++;
+                }
+            }
+        }
+
+        if(outcome.knockedOut.has_value()){
+            auto &player = env->getPlayerRef(outcome.knockedOut.value());
+            record.knockedOut = outcome.knockedOut;
+            record.wasKnockedOut = player.knockedOut;
+            player.knockedOut = true;
+        }
+
+        if(outcome.fined.has_value()){
+            auto &player = env->getPlayerRef(outcome.fined.value());
+            record.fined = outcome.fined;
+            record.wasFined = player.isFined;
+            player.isFined = true;
+        }
+
+        auto leftTeam = env->getTeam(gameModel::TeamSide::LEFT);
+        auto rightTeam = env->getTeam(gameModel::TeamSide::RIGHT);
+        record.scoreLeft = leftTeam->score;
+        record.scoreRight = rightTeam->score;
+        leftTeam->score += outcome.scoreLeft;
+        rightTeam->score += outcome.scoreRight;
+        return record;
+    }
+
+    auto updateHash(std::uint64_t hash, const gameModel::Environment &env, const UndoRecord &record) -> std::uint64_t {
+        for(std::size_t i = 0; i < record.numberOfMoves; i++){
+            const auto &move = record.oldPositions[i];
+            hash ^= gameModel::zobrist::position(move.id, move.target) ^
+                    gameModel::zobrist::position(move.id, getObject(env, move.id).position);
+        }
+
+        for(auto it = record.removedCubes.begin(); it != record.removedCubes.end(); it++){
+            const auto &cube = *it->second;
+            auto isStacked = [&cube](const std::shared_ptr<gameModel::CubeOfShit> &other){
+                return other->position == cube.position && other->spawnedThisRound == cube.spawnedThisRound;
+            };
+
+            auto isRemovedStacked = [&isStacked](const auto &removed){ return isStacked(removed.second); };
+            if(std::none_of(record.removedCubes.begin(), it, isRemovedStacked)){
+                auto removed = static_cast<std::size_t>(std::count_if(it, record.removedCubes.end(), isRemovedStacked));
+                auto left = static_cast<std::size_t>(std::count_if(env.pileOfShit.begin(), env.pileOfShit.end(),
+                        isStacked));
+                hash ^= gameModel::zobrist::cube(cube.position, cube.spawnedThisRound, left + removed) ^
+                        gameModel::zobrist::cube(cube.position, cube.spawnedThisRound, left);
+            }
+        }
+
+        if(record.knockedOut.has_value() && !record.wasKnockedOut){
+            hash ^= gameModel::zobrist::knockedOut(record.knockedOut.value());
+        }
+
+        if(record.fined.has_value() && !record.wasFined){
+            hash ^= gameModel::zobrist::fined(record.fined.value());
+        }
+
+        using Side = gameModel::TeamSide;
+        hash ^= gameModel::zobrist::score(Side::LEFT, record.scoreLeft) ^
+                gameModel::zobrist::score(Side::LEFT, env.getTeam(Side::LEFT)->score);
+        hash ^= gameModel::zobrist::score(Side::RIGHT, record.scoreRight) ^
+                gameModel::zobrist::score(Side::RIGHT, env.getTeam(Side::RIGHT)->score);
+        return hash;
+    }
+
+    auto filterOutcomes(std::vector<ActionOutcome> &outcomes, const OutcomeFilter &filter) -> double {
+        if(outcomes.size() <= filter.maxOutcomes && filter.minProbability <= 0){
+            return 0;
+        }
+
+        std::vector<std::size_t> ranking(outcomes.size());
+        std::iota(ranking.begin(), ranking.end(), 0);
+        std::stable_sort(ranking.begin(), ranking.end(), [&outcomes](std::size_t a, std::size_t b){
+            return outcomes[a].probability > outcomes[b].probability;
+        });
+
+        std::vector<bool> keep(outcomes.size(), false);
+        for(std::size_t rank = 0; rank < ranking.size() && rank < std::max<std::size_t>(filter.maxOutcomes, 1); rank++){
+            if(rank > 0 && outcomes[ranking[rank]].probability < filter.minProbability){
+                break;
+            }
+
+            keep[ranking[rank]] = true;
+        }
+
+        double kept = 0;
+        double dropped = 0;
+        std::size_t size = 0;
+        for(std::size_t i = 0; i < outcomes.size(); i++){
+            if(keep[i]){
+                kept += outcomes[i].probability;
+                outcomes[size++] = outcomes[i];
+            } else {
+                dropped += outcomes[i].probability;
+            }
+        }
+
+        outcomes.resize(size);
+        if(filter.renormalise && dropped > 0 && kept > 0){
+            for(auto &outcome : outcomes){
+                outcome.probability /= kept;
+            }
+        }
+
+        return dropped;
+    }
+
+    void undoOutcome(const std::shared_ptr<gameModel::Environment> &env, const UndoRecord &record) {
+        env->getTeam(gameModel::TeamSide::LEFT)->score = record.scoreLeft;
+        env->getTeam(gameModel::TeamSide::RIGHT)->score = record.scoreRight;
+        if(record.fined.has_value()){
+            env->getPlayerRef(record.fined.value()).isFined = record.wasFined;
+        }
+
+        if(record.knockedOut.has_value()){
+            env->getPlayerRef(record.knockedOut.value()).knockedOut = record.wasKnockedOut;
+        }
+
+        for(auto it = record.removedCubes.rbegin(); it != record.removedCubes.rend(); it++){
+            env->pileOfShit.insert(env->pileOfShit.begin() + static_cast<std::ptrdiff_t>(it->first), it->second);
+        }
+
+        for(std::size_t i = record.numberOfMoves; i > 0; i--){
+            const auto &move = record.oldPositions[i - 1];
+            getObject(*env, move.id).position = move.target;
+        }
+    }
+
 
     Shot::Shot(std::shared_ptr<gameModel::Environment> env, std::shared_ptr<gameModel::Player> actor,
             std::shared_ptr<gameModel::Ball> ball, gameModel::Position target) :
@@ -56,7 +504,7 @@ namespace gameController{
                     } else {
                         //normal intercept
                         auto &p = interceptPlayer.value();
-                        if (!INSTANCE_OF(p, gameModel::Chaser) && !INSTANCE_OF(p, gameModel::Keeper)) {
+                        if (!p->canHoldQuaffle()) {
                             //Quaffle bounces off
                             moveToAdjacent(ball, env);
                         }
@@ -69,7 +517,7 @@ namespace gameController{
             //Quaffle not intercepted
             if(!intercepted) {
                 auto dist = getDistance(actor->position, target);
-                if(actionTriggered(std::pow(env->config.getGameDynamicsProbs().throwSuccess, dist))){
+                if(actionTriggered(env->config.getThrowSuccessProb(dist))){
                     //Throw success
                     ball->position = target;
                 } else {
@@ -116,7 +564,7 @@ namespace gameController{
             auto playerOnTarget = env->getPlayer(target);
             if(playerOnTarget.has_value()){
                 //Knock player out an place bludger on random free cell
-                if(!INSTANCE_OF(playerOnTarget.value(), gameModel::Beater) &&
+                if(playerOnTarget.value()->getRole() != gameModel::PlayerRole::Beater &&
                     actionTriggered(env->config.getGameDynamicsProbs().knockOut)){
                     shotRes.push_back(ActionResult::Knockout);
                     playerOnTarget.value()->knockedOut = true;
@@ -157,17 +605,16 @@ namespace gameController{
                 return 0;
             }
 
-            if(isAnyPlayerOnTarget && !(INSTANCE_OF(playerOnTarget.value(), gameModel::Chaser) ||
-                                        INSTANCE_OF(playerOnTarget.value(), gameModel::Keeper))) {
+            if(isAnyPlayerOnTarget && !playerOnTarget.value()->canHoldQuaffle()) {
                 //Target player cannot hold ball -> 100% bounce off
                 return 0;
             }
 
             //Prob for !interception * prob for !miss
-            return std::pow(1 - env->config.getGameDynamicsProbs().catchQuaffle, getInterceptionPositions().size()) *
-                std::pow(env->config.getGameDynamicsProbs().throwSuccess, getDistance(actor->position, target));
+            return env->config.getNoInterceptionProb(getInterceptionPositions().size()) *
+                env->config.getThrowSuccessProb(getDistance(actor->position, target));
         } else if(BLUDGERSHOT) {
-            if(isAnyPlayerOnTarget && !INSTANCE_OF(playerOnTarget.value(), gameModel::Beater)) {
+            if(isAnyPlayerOnTarget && playerOnTarget.value()->getRole() != gameModel::PlayerRole::Beater) {
                 //Prob for knockout
                 return env->config.getGameDynamicsProbs().knockOut;
             } else {
@@ -186,7 +633,7 @@ namespace gameController{
                 return res::Success;
             } else if(BLUDGERSHOT && getDistance(actor->position, target) <= 3){
                 bool blocked = false;
-                for(const auto &cell : getAllCrossedCells(actor->position, target)){
+                for(const auto &cell : getCrossedCellsView(actor->position, target)){
                     if(env->getPlayer(cell).has_value()){
                         blocked = true;
                         break;
@@ -203,7 +650,7 @@ namespace gameController{
     }
 
     auto Shot::getInterceptionPositions() const -> std::vector<gameModel::Position>{
-        auto crossedCells = gameController::getAllCrossedCells(this->actor->position, target);
+        auto crossedCells = gameController::getCrossedCellsView(this->actor->position, target);
         std::vector<gameModel::Position> ret;
         for(const auto &player : env->getOpponents(actor)){
             for(const auto &cell : crossedCells){
@@ -227,6 +674,7 @@ namespace gameController{
         int endX = target.x + n;
         int startY = target.y - n;
         int endY = target.y + n;
+        const auto freeCells = env->getOccupancy().free();
 
         do {
             for(int yPos = startY; yPos <= endY; yPos++){
@@ -240,7 +688,7 @@ namespace gameController{
                         continue;
                     }
 
-                    if(env->cellIsFree({xPos, yPos})){
+                    if(freeCells[gameModel::cellIndex(xPos, yPos)]){
                         ret.emplace_back(xPos, yPos);
                     }
                 }
@@ -287,23 +735,23 @@ namespace gameController{
         }
     }
 
-    auto Shot::executeAll() const -> std::vector<std::pair<std::shared_ptr<gameModel::Environment>, double>> {
+    auto Shot::getOutcomes() const -> std::vector<ActionOutcome> {
         if (check() == ActionCheckResult::Impossible){
             throw std::runtime_error("Action is impossible");
         }
 
         if(QUAFFLETHROW) {
-            return executeAllQuaffle();
+            return getOutcomesQuaffle();
         } else if(BLUDGERSHOT){
-            return executeAllBludger();
+            return getOutcomesBludger();
         } else {
             throw std::runtime_error("Fatal Error! Illegal Shot!");
         }
     }
 
-    auto Shot::executeAllQuaffle() const -> std::vector<std::pair<std::shared_ptr<gameModel::Environment>, double>> {
+    auto Shot::getOutcomesQuaffle() const -> std::vector<ActionOutcome> {
         const std::shared_ptr<const gameModel::Environment> &localEnv = env;
-        std::vector<std::pair<std::shared_ptr<gameModel::Environment>, double>> ret;
+        OutcomeDistribution ret;
 
 
         //Handle intercepting players
@@ -316,67 +764,73 @@ namespace gameController{
         for(unsigned long i = 0; i < interceptPoints.size(); i++) {
             auto const &interceptPos = interceptPoints[i];
             //baseProb for interception at i-th player
-            double baseProb = std::pow(1 - localEnv->config.getGameDynamicsProbs().catchQuaffle, i) *
+            double baseProb = localEnv->config.getNoInterceptionProb(i) *
                               localEnv->config.getGameDynamicsProbs().catchQuaffle;
             const std::shared_ptr<const gameModel::Player> interceptingPlayer = localEnv->getPlayer(interceptPos).value();
-            if(INSTANCE_OF(interceptingPlayer, const gameModel::Seeker) ||
-               INSTANCE_OF(interceptingPlayer, const gameModel::Beater)) {
+            if(interceptingPlayer->getRole() == gameModel::PlayerRole::Seeker ||
+               interceptingPlayer->getRole() == gameModel::PlayerRole::Beater) {
                 //Bounce off
-                emplaceEnvs(baseProb, localEnv->getAllFreeCellsAround(interceptPos), ret);
+                emplaceOutcomes(baseProb, localEnv->getAllFreeCellsAround(interceptPos), ret);
             } else {
                 //Quaffle catch
                 if(gameModel::Environment::isGoalCell(interceptPos)) {
-                    emplaceEnvs(baseProb, localEnv->getAllFreeCellsAround(interceptPos), ret);
+                    emplaceOutcomes(baseProb, localEnv->getAllFreeCellsAround(interceptPos), ret);
                 } else {
-                    auto newEnv = localEnv->clone();
-                    newEnv->quaffle->position = interceptPos;
-                    ret.emplace_back(newEnv, baseProb);
+                    ActionOutcome outcome;
+                    outcome.probability = baseProb;
+                    outcome.addMove(localEnv->quaffle->getId(), interceptPos);
+                    outcome.clearCell(interceptPos);
+                    ret.add(outcome);
                 }
             }
         }
 
-        double noInterceptProb = std::pow(1 - localEnv->config.getGameDynamicsProbs().catchQuaffle, interceptPoints.size());
-        double throwSuccess = std::pow(localEnv->config.getGameDynamicsProbs().throwSuccess, getDistance(actor->position, target));
+        double noInterceptProb = localEnv->config.getNoInterceptionProb(interceptPoints.size());
+        double throwSuccess = localEnv->config.getThrowSuccessProb(getDistance(actor->position, target));
         //Handle miss
-        emplaceEnvs(noInterceptProb * (1 - throwSuccess), getAllLandingCells(), ret);
+        emplaceOutcomes(noInterceptProb * (1 - throwSuccess), getAllLandingCells(), ret);
 
         //Handle success
         double success = noInterceptProb * throwSuccess;
-        if(playerOnTarget.has_value() && (INSTANCE_OF(playerOnTarget.value(), const gameModel::Seeker) ||
-                                          INSTANCE_OF(playerOnTarget.value(), const gameModel::Beater))) {
-            emplaceEnvs(success, localEnv->getAllFreeCellsAround(target), ret);
+        if(playerOnTarget.has_value() && (playerOnTarget.value()->getRole() == gameModel::PlayerRole::Seeker ||
+                                          playerOnTarget.value()->getRole() == gameModel::PlayerRole::Beater)) {
+            emplaceOutcomes(success, localEnv->getAllFreeCellsAround(target), ret);
         } else {
-            emplaceEnvs(success, {target}, ret);
+            emplaceOutcomes(success, {target}, ret);
         }
 
-        return ret;
+        return ret.release();
     }
 
-    auto Shot::executeAllBludger() const -> std::vector<std::pair<std::shared_ptr<gameModel::Environment>, double>> {
+    auto Shot::getOutcomesBludger() const -> std::vector<ActionOutcome> {
         const std::shared_ptr<const gameModel::Environment> &localEnv = env;
-        std::vector<std::pair<std::shared_ptr<gameModel::Environment>, double>> ret;
+        std::vector<ActionOutcome> ret;
         std::optional<const std::shared_ptr<const gameModel::Player>> playerOnTarget = localEnv->getPlayer(target);
-        auto emplaceKnockoutEnv = [&ret, &playerOnTarget, &localEnv, this](double baseProb, const std::optional<gameModel::Position> &pos){
-            auto knockoutEnv = localEnv->clone();
-            knockoutEnv->getPlayerById(playerOnTarget.value()->getId())->knockedOut = true;
-            auto freeCells = knockoutEnv->getAllFreeCells();
+        auto emplaceKnockoutOutcome = [&ret, &playerOnTarget, &localEnv, this](double baseProb, const std::optional<gameModel::Position> &pos,
+                const std::vector<gameModel::Position> &freeCells){
+            ActionOutcome outcome;
+            outcome.probability = baseProb * localEnv->config.getGameDynamicsProbs().knockOut;
+            outcome.knockedOut = playerOnTarget.value()->getId();
             //non deterministic since branching factor would be way to high
-            knockoutEnv->getBallByID(ball->getId())->position = freeCells[rng(0, static_cast<int>(freeCells.size()) - 1)];
+            outcome.addMove(ball->getId(), freeCells[rng(0, static_cast<int>(freeCells.size()) - 1)]);
             if(pos.has_value()) {
-                knockoutEnv->quaffle->position = pos.value();
-                knockoutEnv->removeShitOnCell(pos.value());
+                outcome.addMove(localEnv->quaffle->getId(), pos.value());
+                outcome.clearCell(pos.value());
             }
 
-            ret.emplace_back(knockoutEnv, baseProb * localEnv->config.getGameDynamicsProbs().knockOut);
+            ret.emplace_back(outcome);
         };
 
-        auto emplaceFailEnv = [&ret, &localEnv, this](){
-            auto failEnv = localEnv->clone();
-            failEnv->getBallByID(ball->getId())->position = target;
-            ret.emplace_back(failEnv, 1 - localEnv->config.getGameDynamicsProbs().knockOut);
+        auto emplaceFailOutcome = [&ret, &localEnv, this](){
+            ActionOutcome outcome;
+            outcome.probability = 1 - localEnv->config.getGameDynamicsProbs().knockOut;
+            outcome.addMove(ball->getId(), target);
+            ret.emplace_back(outcome);
         };
 
-        if(playerOnTarget.has_value() && !INSTANCE_OF(playerOnTarget.value(), const gameModel::Beater)) {
+        if(playerOnTarget.has_value() && playerOnTarget.value()->getRole() != gameModel::PlayerRole::Beater) {
+            //knocking out a player does not change the free cells
+            const auto freeCells = localEnv->getAllFreeCells();
             if(localEnv->quaffle->position == target) {
                 auto landingCells = localEnv->getAllFreeCellsAround(target);
 
@@ -386,54 +840,44 @@ namespace gameController{
 
                 double prob = 1.0 / landingCells.size();
                 for(const auto &cell : landingCells) {
-                    emplaceKnockoutEnv(prob, cell);
+                    emplaceKnockoutOutcome(prob, cell, freeCells);
                 }
 
-                emplaceFailEnv();
+                emplaceFailOutcome();
             } else {
-                emplaceKnockoutEnv(1, std::nullopt);
-                emplaceFailEnv();
+                emplaceKnockoutOutcome(1, std::nullopt, freeCells);
+                emplaceFailOutcome();
             }
         } else {
-            auto newEnv = localEnv->clone();
-            newEnv->getBallByID(ball->getId())->position = target;
-            newEnv->removeShitOnCell(target);
-            ret.emplace_back(newEnv, 1);
+            ActionOutcome outcome;
+            outcome.probability = 1;
+            outcome.addMove(ball->getId(), target);
+            outcome.clearCell(target);
+            ret.emplace_back(outcome);
         }
 
         return ret;
     }
 
-    void Shot::emplaceEnvs(double baseProb, const std::vector<gameModel::Position> &newPoses,
-                           std::vector<std::pair<std::shared_ptr<gameModel::Environment>, double>> &envList) const{
+    void Shot::emplaceOutcomes(double baseProb, const std::vector<gameModel::Position> &newPoses,
+                               OutcomeDistribution &outcomes) const{
             double prob = baseProb / newPoses.size();
+            const auto quaffleId = env->quaffle->getId();
             for(const auto &cell : newPoses) {
-                bool handled = false;
-                for (auto &outcome : envList) {
-                    if (outcome.first->quaffle->position == cell) {
-                        outcome.second += prob;
-                        handled = true;
-                        break;
-                    }
-                }
-
-                if (handled) {
-                    continue;
-                }
-
-                auto newEnv = env->clone();
-                newEnv->quaffle->position = cell;
-                newEnv->removeShitOnCell(cell);
+                ActionOutcome outcome;
+                outcome.probability = prob;
+                outcome.addMove(quaffleId, cell);
+                outcome.clearCell(cell);
                 auto goalRes = goalCheck(cell);
                 if(goalRes.has_value()) {
                     if(goalRes.value() == ActionResult::ScoreLeft) {
-                        newEnv->getTeam(gameModel::TeamSide::LEFT)->score += GOAL_POINTS;
+                        outcome.addScore(gameModel::TeamSide::LEFT, GOAL_POINTS);
                     } else if(goalRes.value() == ActionResult::ScoreRight) {
-                        newEnv->getTeam(gameModel::TeamSide::RIGHT)->score += GOAL_POINTS;
+                        outcome.addScore(gameModel::TeamSide::RIGHT, GOAL_POINTS);
                     }
                 }
 
-                envList.emplace_back(newEnv, prob);
+                outcomes.add(outcome);
             }
     }
 
@@ -501,7 +945,7 @@ namespace gameController{
         }
 
         const bool positionIsTarget = this->env->snitch->position == this->target;
-        const bool isSeeker = (bool) INSTANCE_OF(this->actor, gameModel::Seeker);
+        const bool isSeeker = this->actor->getRole() == gameModel::PlayerRole::Seeker;
         const bool actionWasTriggered = actionTriggered(env->config.getGameDynamicsProbs().catchSnitch);
         if(env->snitch->exists && positionIsTarget && isSeeker && actionWasTriggered) {
 
@@ -532,7 +976,7 @@ namespace gameController{
             //rammed player looses quaffel
             moveToAdjacent(env->quaffle, env);
             actions.push_back(ActionResult::FoolAway);
-        } else if(this->env->quaffle->position == target && !INSTANCE_OF(this->actor, gameModel::Chaser) && !INSTANCE_OF(this->actor, gameModel::Keeper)){
+        } else if(this->env->quaffle->position == target && !this->actor->canHoldQuaffle()){
             moveToAdjacent(env->quaffle, env);
         }
 
@@ -575,13 +1019,13 @@ namespace gameController{
         }
 
         // BlockSnitch
-        const bool actorIsNotSeeker = !INSTANCE_OF(actor, gameModel::Seeker);
+        const bool actorIsNotSeeker = actor->getRole() != gameModel::PlayerRole::Seeker;
         const bool targetIsSnitchPos = this->target == this->env->snitch->position;
         if (actorIsNotSeeker && targetIsSnitchPos && env->snitch->exists) {
             resVect.emplace_back(gameModel::Foul::BlockSnitch);
         }
 
-        if (INSTANCE_OF(actor, gameModel::Chaser)) {
+        if (actor->getRole() == gameModel::PlayerRole::Chaser) {
             const bool actorHadQuaffle = env->quaffle->position == this->actor->position;
             // ChargeGoal
             if ( actorHadQuaffle &&
@@ -597,7 +1041,7 @@ namespace gameController{
                 if(env->isPlayerInOpponentRestrictedZone(actor)){
                     auto mates = env->getTeamMates(actor);
                     for(const auto &p : mates){
-                        if(!p->isFined && INSTANCE_OF(p, gameModel::Chaser) && env->isPlayerInOpponentRestrictedZone(p)){
+                        if(!p->isFined && p->getRole() == gameModel::PlayerRole::Chaser && env->isPlayerInOpponentRestrictedZone(p)){
                             resVect.emplace_back(gameModel::Foul::MultipleOffence);
                         }
                     }
@@ -610,22 +1054,28 @@ namespace gameController{
         return resVect;
     }
 
-    auto Move::executeAll() const ->
-        std::vector<std::pair<std::shared_ptr<gameModel::Environment>, double>> {
+    auto Move::getOutcomes() const -> std::vector<ActionOutcome> {
         if (check() == ActionCheckResult::Impossible){
             throw std::runtime_error("Action is impossible");
         }
 
-        std::vector<std::pair<std::shared_ptr<gameModel::Environment>, double>> ret;
-        executePartially(ret, ActionState::MovePlayers);
-        return ret;
+        std::vector<ActionOutcome> partialOutcomes;
+        executePartially(partialOutcomes, ActionState::MovePlayers);
+        // different branches of executePartially may lead to the same state
+        OutcomeDistribution ret;
+        ret.reserve(partialOutcomes.size());
+        for(const auto &outcome : partialOutcomes){
+            ret.add(outcome);
+        }
+
+        return ret.release();
     }
 
-    void Move::executePartially(std::vector<std::pair<std::shared_ptr<gameModel::Environment>, double>> &resList,
-            ActionState state) const {
+    void Move::executePartially(std::vector<ActionOutcome> &resList, ActionState state) const {
         switch(state) {
             case ActionState::MovePlayers: {
-                if(env->getPlayer(target).has_value()){
+                auto playerOnTarget = env->getPlayer(target);
+                if(playerOnTarget.has_value()){
                     //make actor "invisible"
                     actor->isFined = true;
                     auto freeCells = env->getAllFreeCellsAround(target);
@@ -637,18 +1087,20 @@ namespace gameController{
                     double prob = 1.0 / freeCells.size();
                     resList.reserve(freeCells.size());
                     for(const auto &pos : freeCells){
-                        auto newEnv = env->clone();
+                        ActionOutcome outcome;
+                        outcome.probability = prob;
                         //move target player on adjacent cell
-                        newEnv->getPlayer(target).value()->position = pos;
+                        outcome.addMove(playerOnTarget.value()->getId(), pos);
                         //move actor on target
-                        newEnv->getPlayerById(actor->getId())->position = target;
-                        newEnv->removeShitOnCell(pos);
+                        outcome.addMove(actor->getId(), target);
+                        outcome.clearCell(pos);
 
-                        resList.emplace_back(newEnv, prob);
+                        resList.emplace_back(outcome);
                     }
                 } else {
-                    resList.emplace_back(env->clone(), 1);
-                    resList.back().first->getPlayerById(actor->getId())->position = target;
+                    resList.emplace_back();
+                    resList.back().probability = 1;
+                    resList.back().addMove(actor->getId(), target);
                 }
 
                 executePartially(resList, ActionState::HandleBalls);
@@ -656,39 +1108,40 @@ namespace gameController{
                 break;
             case ActionState::HandleBalls: {
                 std::optional<std::shared_ptr<const gameModel::Player>> playerOnTarget = env->getPlayer(target);
+                const auto quaffleId = env->quaffle->getId();
                 //Handle quaffle
                 if(env->quaffle->position == actor->position &&
-                   (INSTANCE_OF(actor, gameModel::Chaser) || INSTANCE_OF(actor, gameModel::Keeper))) {
+                   actor->canHoldQuaffle()) {
                     //Take Quaffle with actor
                     for(auto &outcome : resList) {
-                        outcome.first->quaffle->position = target;
+                        outcome.addMove(quaffleId, target);
                         if(gameModel::Environment::getCell(target) == gameModel::Cell::GoalLeft) {
-                            outcome.first->getTeam(gameModel::TeamSide::RIGHT)->score += GOAL_POINTS;
+                            outcome.addScore(gameModel::TeamSide::RIGHT, GOAL_POINTS);
                         } else if(gameModel::Environment::getCell(target) == gameModel::Cell::GoalRight) {
-                            outcome.first->getTeam(gameModel::TeamSide::LEFT)->score += GOAL_POINTS;
+                            outcome.addScore(gameModel::TeamSide::LEFT, GOAL_POINTS);
                         }
                     }
-                } else if(env->quaffle->position == target && (INSTANCE_OF(actor, gameModel::Beater) || INSTANCE_OF(actor, gameModel::Seeker) ||
+                } else if(env->quaffle->position == target && (!actor->canHoldQuaffle() ||
                     (playerOnTarget.has_value() && !env->arePlayerInSameTeam(actor, playerOnTarget.value())))) {
-                    std::vector<std::pair<std::shared_ptr<gameModel::Environment>, double>> newOutcomes;
+                    std::vector<ActionOutcome> newOutcomes;
                     //Move Quaffle away from target
+                    const auto freeCells = env->getAllFreeCellsAround(target);
+                    double prob = 1.0 / freeCells.size();
                     for(auto &outcome : resList) {
-                        auto freeCells = env->getAllFreeCellsAround(target);
-                        double prob = 1.0 / freeCells.size();
                         for(auto pos = freeCells.begin(); pos != freeCells.end(); pos++) {
                             if(pos == freeCells.begin()) {
                                 //Alter in place
-                                outcome.first->quaffle->position = *pos;
-                                outcome.first->removeShitOnCell(*pos);
+                                outcome.addMove(quaffleId, *pos);
+                                outcome.clearCell(*pos);
 
-                                outcome.second *= prob;
+                                outcome.probability *= prob;
                             } else {
-                                //Create new envs
-                                auto newEnv = outcome.first->clone();
-                                newEnv->quaffle->position = *pos;
-                                newEnv->removeShitOnCell(*pos);
+                                //Create new outcomes based on the altered one
+                                auto newOutcome = outcome;
+                                newOutcome.addMove(quaffleId, *pos);
+                                newOutcome.clearCell(*pos);
 
-                                newOutcomes.emplace_back(newEnv, outcome.second);
+                                newOutcomes.emplace_back(newOutcome);
                             }
                         }
                     }
@@ -698,16 +1151,16 @@ namespace gameController{
 
                 //Handle snitch
                 if(env->snitch->exists && env->snitch->position == target &&
-                    INSTANCE_OF(actor, gameModel::Seeker)) {
-                    std::vector<std::pair<std::shared_ptr<gameModel::Environment>, double>> newOutcomes;
-                    newOutcomes.reserve(resList.size() * 2);
+                    actor->getRole() == gameModel::PlayerRole::Seeker) {
+                    std::vector<ActionOutcome> newOutcomes;
+                    newOutcomes.reserve(resList.size());
+                    const auto actorSide = gameLogic::conversions::idToSide(actor->getId());
                     for(auto &outcome : resList) {
-                        auto catchFailEnv = outcome.first->clone();
-                        auto catchFailBaseProb = outcome.second;
-                        auto tempActorSucc = outcome.first->getPlayerById(actor->getId());
-                        outcome.first->getTeam(tempActorSucc)->score += SNITCH_POINTS;
-                        outcome.second *= env->config.getGameDynamicsProbs().catchSnitch;
-                        newOutcomes.emplace_back(catchFailEnv, catchFailBaseProb * (1 - env->config.getGameDynamicsProbs().catchSnitch));
+                        auto catchFailOutcome = outcome;
+                        catchFailOutcome.probability *= 1 - env->config.getGameDynamicsProbs().catchSnitch;
+                        outcome.addScore(actorSide, SNITCH_POINTS);
+                        outcome.probability *= env->config.getGameDynamicsProbs().catchSnitch;
+                        newOutcomes.emplace_back(catchFailOutcome);
                     }
 
                     resList.insert(resList.end(), newOutcomes.begin(), newOutcomes.end());
@@ -719,13 +1172,14 @@ namespace gameController{
             case ActionState::HandleFouls: {
                 double success = successProb();
                 if(std::abs(1 - success) > std::numeric_limits<double>::epsilon()){
-                    std::vector<std::pair<std::shared_ptr<gameModel::Environment>, double>> newOutcomes;
-                    resList.reserve(resList.size() * 2);
+                    std::vector<ActionOutcome> newOutcomes;
+                    newOutcomes.reserve(resList.size());
                     for(auto &outcome : resList){
-                        auto newEnv = outcome.first->clone();
-                        newEnv->getPlayerById(actor->getId())->isFined = true;
-                        newOutcomes.emplace_back(newEnv, outcome.second * (1 - success));
-                        outcome.second *= success;
+                        auto newOutcome = outcome;
+                        newOutcome.fined = actor->getId();
+                        newOutcome.probability *= 1 - success;
+                        newOutcomes.emplace_back(newOutcome);
+                        outcome.probability *= success;
                     }
 
                     resList.insert(resList.end(), newOutcomes.begin(), newOutcomes.end());
@@ -776,10 +1230,10 @@ namespace gameController{
             return ActionCheckResult::Impossible;
         }
 
-        if (INSTANCE_OF(player.value(), gameModel::Chaser)) {
+        if (player.value()->getRole() == gameModel::PlayerRole::Chaser) {
             return ActionCheckResult::Success;
         }
-        else if (INSTANCE_OF(player.value(), gameModel::Keeper) && !env->isPlayerInOwnRestrictedZone(player.value())){
+        else if (player.value()->getRole() == gameModel::PlayerRole::Keeper && !env->isPlayerInOwnRestrictedZone(player.value())){
             return ActionCheckResult::Success;
         }
         else {
@@ -787,19 +1241,19 @@ namespace gameController{
         }
     }
 
-    auto WrestQuaffle::executeAll() const ->
-        std::vector<std::pair<std::shared_ptr<gameModel::Environment>, double>> {
+    auto WrestQuaffle::getOutcomes() const -> std::vector<ActionOutcome> {
         if(check() == ActionCheckResult::Impossible){
             throw std::runtime_error("Action is impossible");
         }
 
-        std::vector<std::pair<std::shared_ptr<gameModel::Environment>, double>> ret;
-        ret.reserve(2);
-        ret.emplace_back(env->clone(), 1 - env->config.getGameDynamicsProbs().wrestQuaffle);
-        auto successEnv = env->clone();
-        successEnv->quaffle->position = actor->position;
-        ret.emplace_back(successEnv, env->config.getGameDynamicsProbs().wrestQuaffle);
-        return ret;
-
+        ActionOutcome fail;
+        fail.probability = 1 - env->config.getGameDynamicsProbs().wrestQuaffle;
+        ActionOutcome success;
+        success.probability = env->config.getGameDynamicsProbs().wrestQuaffle;
+        success.addMove(env->quaffle->getId(), actor->position);
+        OutcomeDistribution ret;
+        ret.add(fail);
+        ret.add(success);
+        return ret.release();
     }
 }
@@ -11,6 +11,11 @@
 #include <memory>
 #include <cmath>
 #include <vector>
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <limits>
+#include <unordered_map>
 #include "GameController.h"
 #include "GameModel.h"
 
@@ -42,6 +47,229 @@ namespace gameController{
         FoolAway ///> Quaffle was lost
     };
 
+    /**
+     * Describes one possible outcome of an Action as the changes it makes to an Environment
+     */
+    struct ActionOutcome {
+        static constexpr std::size_t MAX_MOVES = 3;
+        static constexpr std::size_t MAX_CLEARED_CELLS = 3;
+
+        /**
+         * New position of a player or ball
+         */
+        struct ObjectMove {
+            communication::messages::types::EntityId id;
+            gameModel::Position target;
+        };
+
+        double probability = 0; ///< probability of the outcome
+        std::array<ObjectMove, MAX_MOVES> moves{}; ///< objects changing their position
+        std::uint8_t numberOfMoves = 0;
+        std::array<gameModel::Position, MAX_CLEARED_CELLS> clearedCells{}; ///< cells where all CubeOfShit are removed
+        std::uint8_t numberOfClearedCells = 0;
+        std::optional<communication::messages::types::EntityId> knockedOut; ///< player who is knocked out
+        std::optional<communication::messages::types::EntityId> fined; ///< player who is banned
+        int scoreLeft = 0; ///< points scored by the left team
+        int scoreRight = 0; ///< points scored by the right team
+
+        /**
+         * Sets the new position of an object. Replaces the position if the object is already moved by the outcome
+         * @param id id of the player or ball
+         * @param position new position of the object
+         * @throws std::runtime_error if more than MAX_MOVES objects are moved
+         */
+        void addMove(communication::messages::types::EntityId id, const gameModel::Position &position);
+
+        /**
+         * Gets the new position of an object
+         * @param id id of the player or ball
+         * @return the new position or nothing if the object is not moved by the outcome
+         */
+        auto getMove(communication::messages::types::EntityId id) const -> std::optional<gameModel::Position>;
+
+        /**
+         * Marks a cell to be cleared from all CubeOfShit
+         * @param cell
+         * @throws std::runtime_error if more than MAX_CLEARED_CELLS cells are cleared
+         */
+        void clearCell(const gameModel::Position &cell);
+
+        /**
+         * Adds the points to the score of the given team
+         * @param side side of the team
+         * @param points
+         */
+        void addScore(gameModel::TeamSide side, int points);
+
+        /**
+         * Checks if two outcomes change the Environment in the same way. The probability and the order in which
+         * moves and cleared cells were added are ignored.
+         * @param other
+         * @return true if both outcomes result in the same state, false otherwise
+         */
+        bool hasSameEffect(const ActionOutcome &other) const;
+
+        /**
+         * Hash consistent with hasSameEffect
+         * @return hash of the effect of the outcome
+         */
+        auto getEffectHash() const -> std::uint64_t;
+    };
+
+    /**
+     * Outcomes of an Action in which outcomes with the same effect are merged by adding up their probabilities.
+     * Merge candidates are looked up by hash, outcomes keep the order in which they were first added.
+     */
+    class OutcomeDistribution {
+    public:
+        /**
+         * Reserves memory for the given number of distinct outcomes
+         * @param capacity
+         */
+        void reserve(std::size_t capacity);
+
+        /**
+         * Adds an outcome. If an outcome with the same effect was added before, only the probability is added to it.
+         * @param outcome
+         */
+        void add(const ActionOutcome &outcome);
+
+        /**
+         * Getter
+         * @return number of distinct outcomes
+         */
+        auto size() const -> std::size_t;
+
+        auto operator[](std::size_t index) const -> const ActionOutcome &;
+
+        /**
+         * Moves the outcomes out of the distribution and clears it
+         * @return all distinct outcomes
+         */
+        auto release() -> std::vector<ActionOutcome>;
+
+    private:
+        std::vector<ActionOutcome> outcomes;
+        std::unordered_multimap<std::uint64_t, std::size_t> index;
+    };
+
+    /**
+     * Contains everything needed to revert an ActionOutcome applied to an Environment
+     */
+    struct UndoRecord {
+        std::array<ActionOutcome::ObjectMove, ActionOutcome::MAX_MOVES> oldPositions{};
+        std::uint8_t numberOfMoves = 0;
+        std::optional<communication::messages::types::EntityId> knockedOut;
+        bool wasKnockedOut = false;
+        std::optional<communication::messages::types::EntityId> fined;
+        bool wasFined = false;
+        int scoreLeft = 0;
+        int scoreRight = 0;
+        std::vector<std::pair<std::size_t, std::shared_ptr<gameModel::CubeOfShit>>> removedCubes; ///< cubes in order of removal with their index
+    };
+
+    /**
+     * Applies an outcome in place. No memory is allocated unless cubes of shit are removed.
+     * @param env the environment to operate on
+     * @param outcome the outcome to apply
+     * @return the record needed to undo the changes
+     */
+    auto applyOutcome(const std::shared_ptr<gameModel::Environment> &env, const ActionOutcome &outcome) -> UndoRecord;
+
+    /**
+     * Reverts the changes made by applyOutcome. All outcomes applied afterwards have to be undone first.
+     * @param env the environment the outcome was applied to
+     * @param record the record returned by applyOutcome
+     */
+    void undoOutcome(const std::shared_ptr<gameModel::Environment> &env, const UndoRecord &record);
+
+    /**
+     * Updates a Zobrist key incrementally after applyOutcome instead of recalculating it with Environment::getHash
+     * @param hash the key of the Environment before the outcome was applied
+     * @param env the Environment after the outcome was applied
+     * @param record the record returned by applyOutcome
+     * @return the key of env
+     */
+    auto updateHash(std::uint64_t hash, const gameModel::Environment &env, const UndoRecord &record) -> std::uint64_t;
+
+    /**
+     * Selects the outcomes of an Action worth materializing
+     */
+    struct OutcomeFilter {
+        double minProbability = 0; ///< outcomes less likely than this are dropped
+        std::size_t maxOutcomes = std::numeric_limits<std::size_t>::max(); ///< only the most likely outcomes are kept
+        bool renormalise = true; ///< scale the kept outcomes to a total probability of 1 instead of leaving a residual
+    };
+
+    /**
+     * Drops the unlikely outcomes of an Action. The most likely outcome is always kept, the kept outcomes stay in
+     * their original order.
+     * @param outcomes outcomes as returned by Action::getOutcomes
+     * @param filter selects the outcomes to keep
+     * @return summed up probability of the dropped outcomes (the residual)
+     */
+    auto filterOutcomes(std::vector<ActionOutcome> &outcomes, const OutcomeFilter &filter) -> double;
+
+    /**
+     * Enumerates the outcomes of an Action one at a time. Only the compact ActionOutcome descriptions are held,
+     * resulting Environments are created on request with materialize.
+     */
+    class OutcomeEnumerator {
+    public:
+        /**
+         * Order in which the outcomes are enumerated
+         */
+        enum class Order {
+            AsExecuteAll, ///< same order as Action::executeAll
+            MostLikelyFirst ///< descending probability, allows to stop once the remaining probability is negligible
+        };
+
+        /**
+         * main constructor for the OutcomeEnumerator class.
+         * @param env the environment the outcomes are applied to
+         * @param outcomes all outcomes of an Action
+         * @param order order of the enumeration
+         */
+        OutcomeEnumerator(std::shared_ptr<const gameModel::Environment> env, std::vector<ActionOutcome> outcomes,
+                Order order = Order::AsExecuteAll);
+
+        /**
+         * Advances to the next outcome. Has to be called once before accessing the first outcome.
+         * @return false if there are no more outcomes, true otherwise
+         */
+        bool next();
+
+        /**
+         * Gets the current outcome
+         * @return the outcome
+         */
+        auto current() const -> const ActionOutcome &;
+
+        /**
+         * Creates the Environment resulting from the current outcome
+         * @return a modified copy of the environment
+         */
+        auto materialize() const -> std::shared_ptr<gameModel::Environment>;
+
+        /**
+         * Gets the summed up probability of all outcomes after the current one
+         * @return the remaining probability
+         */
+        auto remainingProbability() const -> double;
+
+        /**
+         * Getter
+         * @return total number of outcomes
+         */
+        auto size() const -> std::size_t;
+
+    private:
+        std::shared_ptr<const gameModel::Environment> env;
+        std::vector<ActionOutcome> outcomes;
+        std::size_t visited = 0;
+        double remaining = 0;
+    };
+
     class Action {
     public:
 
@@ -87,10 +315,71 @@ namespace gameController{
 
         /**
          * Produces a list with all possible outcomes of the Action and the respective transition probabilities.
+         * @throws std::runtime_error if Action is impossible
          * @return List of pairs consisting of the resulting Environment and the probability of landing in that state
          */
-        virtual auto executeAll() const ->
-            std::vector<std::pair<std::shared_ptr<gameModel::Environment>, double>> = 0;
+        auto executeAll() const -> std::vector<std::pair<std::shared_ptr<gameModel::Environment>, double>>;
+
+        /**
+         * Same as executeAll but only creates Environments for the outcomes selected by the filter
+         * @param filter selects the outcomes to create Environments for (see filterOutcomes)
+         * @param residual if not nullptr, is set to the summed up probability of the dropped outcomes
+         * @throws std::runtime_error if Action is impossible
+         * @return List of pairs consisting of the resulting Environment and the probability of landing in that state
+         */
+        auto executeAll(const OutcomeFilter &filter, double *residual = nullptr) const ->
+            std::vector<std::pair<std::shared_ptr<gameModel::Environment>, double>>;
+
+        /**
+         * Same as executeAll but the resulting Environments are created with Environment::fork and only copy the
+         * objects changed by their outcome. Everything else is shared with each other and with the Environment of
+         * the Action, so they are read only (see Environment::fork).
+         * @param filter selects the outcomes to create Environments for (see filterOutcomes)
+         * @param residual if not nullptr, is set to the summed up probability of the dropped outcomes
+         * @throws std::runtime_error if Action is impossible
+         * @return List of pairs consisting of the resulting Environment and the probability of landing in that state
+         */
+        auto executeAllShared(const OutcomeFilter &filter = {}, double *residual = nullptr) const ->
+            std::vector<std::pair<std::shared_ptr<const gameModel::Environment>, double>>;
+
+        /**
+         * Describes all possible outcomes of the Action without modifying or copying the Environment. The outcomes
+         * are in the same order as the Environments returned by executeAll.
+         * @throws std::runtime_error if Action is impossible
+         * @return List of all outcomes
+         */
+        virtual auto getOutcomes() const -> std::vector<ActionOutcome> = 0;
+
+        /**
+         * Applies the outcome with the given index (see getOutcomes) to the Environment in place
+         * @param outcomeIndex index of the outcome
+         * @throws std::runtime_error if the Action is already applied
+         * @throws std::out_of_range if there is no outcome with the given index
+         */
+        void apply(std::size_t outcomeIndex);
+
+        /**
+         * Applies the given outcome of the Action to the Environment in place. Until undo is called the Action
+         * operates on the modified Environment.
+         * @param outcome outcome obtained from getOutcomes
+         * @throws std::runtime_error if the Action is already applied
+         */
+        void apply(const ActionOutcome &outcome);
+
+        /**
+         * Reverts the last call to apply
+         * @throws std::runtime_error if the Action is not applied
+         */
+        void undo();
+
+        /**
+         * Enumerates the outcomes of the Action without creating an Environment for each of them
+         * @param order order of the enumeration
+         * @throws std::runtime_error if Action is impossible
+         * @return enumerator over all outcomes
+         */
+        auto enumerateOutcomes(OutcomeEnumerator::Order order = OutcomeEnumerator::Order::AsExecuteAll) const ->
+            OutcomeEnumerator;
 
         /**
          * Getter
@@ -102,6 +391,7 @@ namespace gameController{
         std::shared_ptr<gameModel::Player> actor;
         std::shared_ptr<gameModel::Environment> env;
         gameModel::Position target{};
+        std::optional<UndoRecord> undoRecord;
     };
 
     /**
@@ -130,8 +420,7 @@ namespace gameController{
          */
         auto successProb() const -> double override;
         auto check() const -> ActionCheckResult override;
-        auto executeAll() const ->
-            std::vector<std::pair<std::shared_ptr<gameModel::Environment>, double>> override;
+        auto getOutcomes() const -> std::vector<ActionOutcome> override;
         /**
          * Checks if the defined Shot will result in a goal if it succeeds
          * @return an ActionResult with the appropriate message or nothing if no goal will be scored
@@ -173,26 +462,26 @@ namespace gameController{
         auto goalCheck(const gameModel::Position &pos) const -> std::optional<ActionResult>;
 
         /**
-         * creates all Environments for Quaffle throws
-         * @return see Action::executeAll
+         * creates all outcomes for Quaffle throws
+         * @return see Action::getOutcomes
          */
-        auto executeAllQuaffle() const -> std::vector<std::pair<std::shared_ptr<gameModel::Environment>, double>>;
+        auto getOutcomesQuaffle() const -> std::vector<ActionOutcome>;
 
         /**
-         * creates all Environments for Bludger shots
-         * @return see Action::executeAll
+         * creates all outcomes for Bludger shots
+         * @return see Action::getOutcomes
          */
-        auto executeAllBludger() const -> std::vector<std::pair<std::shared_ptr<gameModel::Environment>, double>>;
+        auto getOutcomesBludger() const -> std::vector<ActionOutcome>;
 
         /**
-         * emplaces new Envs in return-list where the Quaffle landed on a cell in newPoses
-         * and makes sure that no duplicate envs are created.
+         * emplaces new outcomes in the distribution where the Quaffle landed on a cell in newPoses.
+         * Outcomes landing on the same cell are merged by the distribution.
          * @param baseProb the probability that the Quaffle reached any of the cells in newPoses
-         * @param newPoses positions for new envs
-         * @param envList list where new envs and their corresponding probabilities are constructed
+         * @param newPoses positions for new outcomes
+         * @param outcomes distribution where new outcomes are constructed
          */
-        void emplaceEnvs(double baseProb, const std::vector<gameModel::Position> &newPoses,
-                std::vector<std::pair<std::shared_ptr<gameModel::Environment>, double>> &envList) const;
+        void emplaceOutcomes(double baseProb, const std::vector<gameModel::Position> &newPoses,
+                OutcomeDistribution &outcomes) const;
     };
 
     /**
@@ -225,8 +514,7 @@ namespace gameController{
          */
         auto successProb() const -> double override;
         auto check() const -> ActionCheckResult override;
-        auto executeAll() const ->
-            std::vector<std::pair<std::shared_ptr<gameModel::Environment>, double>> override;
+        auto getOutcomes() const -> std::vector<ActionOutcome> override;
 
     };
 
@@ -259,8 +547,7 @@ namespace gameController{
          */
         auto successProb() const -> double override;
         auto check() const -> ActionCheckResult override;
-        auto executeAll() const ->
-            std::vector<std::pair<std::shared_ptr<gameModel::Environment>, double>> override;
+        auto getOutcomes() const -> std::vector<ActionOutcome> override;
 
         /**
          * checks if the move is a foul.
@@ -275,8 +562,7 @@ namespace gameController{
             HandleBalls
         };
 
-        void executePartially(std::vector<std::pair<std::shared_ptr<gameModel::Environment>, double>> &resList,
-                ActionState state) const;
+        void executePartially(std::vector<ActionOutcome> &resList, ActionState state) const;
     };
 
 }
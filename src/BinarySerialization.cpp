@@ -0,0 +1,416 @@
+/**
+ * @file BinarySerialization.cpp
+ * @date
+ * @brief Implementation of a compact, versioned binary encoding of the Environment.
+ */
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include "BinarySerialization.h"
+
+namespace gameModel {
+
+    namespace {
+        constexpr std::array<std::uint8_t, 2> MAGIC = {'Q', 'E'};
+        constexpr std::uint8_t FLAG_CONFIG = 1u;
+        constexpr std::uint8_t FLAG_SNITCH_EXISTS = 1u;
+        constexpr std::uint8_t BROOM_MASK = 0x07u;
+        constexpr std::uint8_t FLAG_FINED = 1u << 3u;
+        constexpr std::uint8_t FLAG_KNOCKED_OUT = 1u << 4u;
+        constexpr std::size_t NUMBER_OF_CELLS = FIELD_WIDTH * FIELD_HEIGHT;
+
+        constexpr std::array<InterferenceType, 5> fanTypes =
+                {InterferenceType::Teleport, InterferenceType::RangedAttack, InterferenceType::Impulse,
+                 InterferenceType::SnitchPush, InterferenceType::BlockCell};
+
+        constexpr std::array<communication::messages::types::Broom, 5> brooms =
+                {communication::messages::types::Broom::TINDERBLAST, communication::messages::types::Broom::FIREBOLT,
+                 communication::messages::types::Broom::NIMBUS2001, communication::messages::types::Broom::COMET260,
+                 communication::messages::types::Broom::CLEANSWEEP11};
+
+        void writeConfig(BinaryWriter &writer, const Config &config) {
+            writer.writeVarint(config.getMaxRounds());
+            const auto &dynamics = config.getGameDynamicsProbs();
+            for (double prob : {dynamics.catchSnitch, dynamics.knockOut, dynamics.throwSuccess, dynamics.catchQuaffle,
+                                dynamics.wrestQuaffle}) {
+                writer.writeDouble(prob);
+            }
+
+            for (auto type : fanTypes) {
+                writer.writeDouble(config.getFoulDetectionProb(type));
+            }
+
+            for (auto foul : {Foul::MultipleOffence, Foul::Ramming, Foul::BlockGoal, Foul::BlockSnitch,
+                              Foul::ChargeGoal}) {
+                writer.writeDouble(config.getFoulDetectionProb(foul));
+            }
+
+            for (auto broom : brooms) {
+                writer.writeDouble(config.getExtraTurnProb(broom));
+            }
+        }
+
+        auto readConfig(BinaryReader &reader) -> Config {
+            const auto maxRounds = reader.readVarint();
+            GameDynamicsProbs dynamics{};
+            dynamics.catchSnitch = reader.readDouble();
+            dynamics.knockOut = reader.readDouble();
+            dynamics.throwSuccess = reader.readDouble();
+            dynamics.catchQuaffle = reader.readDouble();
+            dynamics.wrestQuaffle = reader.readDouble();
+
+            FoulDetectionProbs fouls{};
+            fouls.teleport = reader.readDouble();
+            fouls.rangedAttack = reader.readDouble();
+            fouls.impulse = reader.readDouble();
+            fouls.snitchPush = reader.readDouble();
+            fouls.blockCell = reader.readDouble();
+            fouls.multipleOffence = reader.readDouble();
+            fouls.ramming = reader.readDouble();
+            fouls.blockGoal = reader.readDouble();
+            fouls.blockSnitch = reader.readDouble();
+            fouls.chargeGoal = reader.readDouble();
+
+            std::map<communication::messages::types::Broom, double> extraTurnProbs;
+            for (auto broom : brooms) {
+                extraTurnProbs.emplace(broom, reader.readDouble());
+            }
+
+            return {static_cast<unsigned int>(maxRounds), fouls, dynamics, std::move(extraTurnProbs)};
+        }
+
+        void writePlayer(BinaryWriter &writer, const Player &player) {
+            writer.writeCell(player.position);
+            writer.writeByte(static_cast<std::uint8_t>(player.getId()));
+            auto flags = static_cast<std::uint8_t>(static_cast<std::uint8_t>(player.broom) & BROOM_MASK);
+            if (player.isFined) {
+                flags |= FLAG_FINED;
+            }
+
+            if (player.knockedOut) {
+                flags |= FLAG_KNOCKED_OUT;
+            }
+
+            writer.writeByte(flags);
+        }
+
+        auto toBroom(std::uint8_t flags) -> communication::messages::types::Broom {
+            if ((flags & BROOM_MASK) >= brooms.size()) {
+                throw std::runtime_error("Invalid broom in binary environment");
+            }
+
+            return static_cast<communication::messages::types::Broom>(flags & BROOM_MASK);
+        }
+
+        /**
+         * Reads a player of one slot of a team
+         * @param ids ids of the players that may occupy the slot
+         * @throws std::runtime_error if the id of the player is not in ids
+         */
+        template<typename T, std::size_t N>
+        auto readPlayer(BinaryReader &reader, const std::array<communication::messages::types::EntityId, N> &ids) -> T {
+            const auto position = reader.readCell();
+            const auto id = static_cast<communication::messages::types::EntityId>(reader.readByte());
+            const auto flags = reader.readByte();
+            if (std::find(ids.begin(), ids.end(), id) == ids.end()) {
+                throw std::runtime_error("Invalid player id in binary environment");
+            }
+
+            T player{position, toBroom(flags), id};
+            player.isFined = (flags & FLAG_FINED) != 0;
+            player.knockedOut = (flags & FLAG_KNOCKED_OUT) != 0;
+            return player;
+        }
+
+        void writeTeam(BinaryWriter &writer, const Team &team) {
+            writer.writeByte(static_cast<std::uint8_t>(team.getSide()));
+            writer.writeSignedVarint(team.score);
+            for (auto type : fanTypes) {
+                writer.writeVarint(static_cast<std::uint64_t>(team.fanblock.getUses(type)));
+                writer.writeVarint(static_cast<std::uint64_t>(team.fanblock.getBannedCount(type)));
+            }
+
+            writePlayer(writer, *team.seeker);
+            writePlayer(writer, *team.keeper);
+            for (const auto &beater : team.beaters) {
+                writePlayer(writer, *beater);
+            }
+
+            for (const auto &chaser : team.chasers) {
+                writePlayer(writer, *chaser);
+            }
+        }
+
+        auto readTeam(BinaryReader &reader) -> std::shared_ptr<Team> {
+            const auto side = reader.readByte();
+            if (side > static_cast<std::uint8_t>(TeamSide::RIGHT)) {
+                throw std::runtime_error("Invalid team side in binary environment");
+            }
+
+            const auto score = static_cast<int>(reader.readSignedVarint());
+            std::array<int, fanTypes.size()> uses{};
+            std::array<int, fanTypes.size()> banned{};
+            for (std::size_t i = 0; i < fanTypes.size(); i++) {
+                uses[i] = static_cast<int>(reader.readVarint());
+                banned[i] = static_cast<int>(reader.readVarint());
+            }
+
+            Fanblock fanblock{uses[0] + banned[0], uses[1] + banned[1], uses[2] + banned[2], uses[3] + banned[3],
+                              uses[4] + banned[4]};
+            for (std::size_t i = 0; i < fanTypes.size(); i++) {
+                for (int j = 0; j < banned[i]; j++) {
+                    fanblock.banFan(fanTypes[i]);
+                }
+            }
+
+            using Id = communication::messages::types::EntityId;
+            const auto left = static_cast<TeamSide>(side) == TeamSide::LEFT;
+            auto seeker = readPlayer<Seeker>(reader, std::array<Id, 1>{left ? Id::LEFT_SEEKER : Id::RIGHT_SEEKER});
+            auto keeper = readPlayer<Keeper>(reader, std::array<Id, 1>{left ? Id::LEFT_KEEPER : Id::RIGHT_KEEPER});
+            const auto beaterIds = left ? std::array<Id, 2>{Id::LEFT_BEATER1, Id::LEFT_BEATER2} :
+                                   std::array<Id, 2>{Id::RIGHT_BEATER1, Id::RIGHT_BEATER2};
+            const auto chaserIds = left ? std::array<Id, 3>{Id::LEFT_CHASER1, Id::LEFT_CHASER2, Id::LEFT_CHASER3} :
+                                   std::array<Id, 3>{Id::RIGHT_CHASER1, Id::RIGHT_CHASER2, Id::RIGHT_CHASER3};
+            std::array<Beater, 2> beaters{readPlayer<Beater>(reader, beaterIds), readPlayer<Beater>(reader, beaterIds)};
+            std::array<Chaser, 3> chasers{readPlayer<Chaser>(reader, chaserIds), readPlayer<Chaser>(reader, chaserIds),
+                                          readPlayer<Chaser>(reader, chaserIds)};
+            return std::make_shared<Team>(std::move(seeker), std::move(keeper), std::move(beaters), std::move(chasers),
+                                          score, std::move(fanblock), static_cast<TeamSide>(side));
+        }
+    }
+
+    BinaryWriter::BinaryWriter(std::vector<std::uint8_t> &buffer) : buffer(buffer) {}
+
+    void BinaryWriter::writeByte(std::uint8_t value) {
+        buffer.push_back(value);
+    }
+
+    void BinaryWriter::writeUint32(std::uint32_t value) {
+        for (unsigned int i = 0; i < 4; i++) {
+            buffer.push_back(static_cast<std::uint8_t>(value >> (8 * i)));
+        }
+    }
+
+    void BinaryWriter::writeUint64(std::uint64_t value) {
+        for (unsigned int i = 0; i < 8; i++) {
+            buffer.push_back(static_cast<std::uint8_t>(value >> (8 * i)));
+        }
+    }
+
+    void BinaryWriter::writeVarint(std::uint64_t value) {
+        while (value >= 0x80u) {
+            buffer.push_back(static_cast<std::uint8_t>(value | 0x80u));
+            value >>= 7u;
+        }
+
+        buffer.push_back(static_cast<std::uint8_t>(value));
+    }
+
+    void BinaryWriter::writeSignedVarint(std::int64_t value) {
+        writeVarint((static_cast<std::uint64_t>(value) << 1u) ^ static_cast<std::uint64_t>(value >> 63));
+    }
+
+    void BinaryWriter::writeDouble(double value) {
+        std::uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        writeUint64(bits);
+    }
+
+    void BinaryWriter::writeCell(const Position &position) {
+        if (position.x < 0 || position.x >= FIELD_WIDTH || position.y < 0 || position.y >= FIELD_HEIGHT) {
+            throw std::invalid_argument("Position is not on the field");
+        }
+
+        buffer.push_back(static_cast<std::uint8_t>(cellIndex(position.x, position.y)));
+    }
+
+    void BinaryWriter::writeBytes(const std::uint8_t *data, std::size_t size) {
+        buffer.insert(buffer.end(), data, data + size);
+    }
+
+    auto BinaryWriter::size() const -> std::size_t {
+        return buffer.size();
+    }
+
+    BinaryReader::BinaryReader(const std::uint8_t *data, std::size_t size) : data(data), size(size) {}
+
+    void BinaryReader::require(std::size_t bytes) const {
+        if (size - pos < bytes) {
+            throw std::runtime_error("Binary data is truncated");
+        }
+    }
+
+    auto BinaryReader::readByte() -> std::uint8_t {
+        require(1);
+        return data[pos++];
+    }
+
+    auto BinaryReader::readUint32() -> std::uint32_t {
+        require(4);
+        std::uint32_t value = 0;
+        for (unsigned int i = 0; i < 4; i++) {
+            value |= static_cast<std::uint32_t>(data[pos++]) << (8 * i);
+        }
+
+        return value;
+    }
+
+    auto BinaryReader::readUint64() -> std::uint64_t {
+        require(8);
+        std::uint64_t value = 0;
+        for (unsigned int i = 0; i < 8; i++) {
+            value |= static_cast<std::uint64_t>(data[pos++]) << (8 * i);
+        }
+
+        return value;
+    }
+
+    auto BinaryReader::readVarint() -> std::uint64_t {
+        std::uint64_t value = 0;
+        for (unsigned int shift = 0; shift < 64; shift += 7) {
+            const auto byte = readByte();
+            value |= static_cast<std::uint64_t>(byte & 0x7Fu) << shift;
+            if ((byte & 0x80u) == 0) {
+                return value;
+            }
+        }
+
+        throw std::runtime_error("Varint is too long");
+    }
+
+    auto BinaryReader::readSignedVarint() -> std::int64_t {
+        const auto value = readVarint();
+        return static_cast<std::int64_t>(value >> 1u) ^ -static_cast<std::int64_t>(value & 1u);
+    }
+
+    auto BinaryReader::readDouble() -> double {
+        const auto bits = readUint64();
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    auto BinaryReader::readCell() -> Position {
+        const auto index = readByte();
+        if (index >= NUMBER_OF_CELLS) {
+            throw std::runtime_error("Invalid cell index in binary data");
+        }
+
+        return {index / FIELD_HEIGHT, index % FIELD_HEIGHT};
+    }
+
+    auto BinaryReader::readBytes(std::size_t count) -> const std::uint8_t * {
+        require(count);
+        const auto *ret = data + pos;
+        pos += count;
+        return ret;
+    }
+
+    auto BinaryReader::remaining() const -> std::size_t {
+        return size - pos;
+    }
+
+    auto BinaryReader::offset() const -> std::size_t {
+        return pos;
+    }
+
+    void writeEnvironment(BinaryWriter &writer, const Environment &env, bool includeConfig) {
+        writer.writeBytes(MAGIC.data(), MAGIC.size());
+        writer.writeByte(BINARY_FORMAT_VERSION);
+        writer.writeByte(includeConfig ? FLAG_CONFIG : 0);
+        if (includeConfig) {
+            writeConfig(writer, env.config);
+        }
+
+        writeTeam(writer, *env.team1);
+        writeTeam(writer, *env.team2);
+        writer.writeCell(env.quaffle->position);
+        writer.writeCell(env.snitch->position);
+        writer.writeCell(env.bludgers[0]->position);
+        writer.writeCell(env.bludgers[1]->position);
+        writer.writeByte(env.snitch->exists ? FLAG_SNITCH_EXISTS : 0);
+
+        writer.writeVarint(env.pileOfShit.size());
+        std::vector<std::uint8_t> spawned((env.pileOfShit.size() + 7) / 8, 0);
+        for (std::size_t i = 0; i < env.pileOfShit.size(); i++) {
+            writer.writeCell(env.pileOfShit[i]->position);
+            if (env.pileOfShit[i]->spawnedThisRound) {
+                spawned[i / 8] |= static_cast<std::uint8_t>(1u << (i % 8));
+            }
+        }
+
+        writer.writeBytes(spawned.data(), spawned.size());
+    }
+
+    auto readEnvironment(BinaryReader &reader, const std::optional<Config> &config) -> std::shared_ptr<Environment> {
+        const auto *magic = reader.readBytes(MAGIC.size());
+        if (!std::equal(MAGIC.begin(), MAGIC.end(), magic)) {
+            throw std::runtime_error("Data is no binary environment");
+        }
+
+        const auto version = reader.readByte();
+        if (version != BINARY_FORMAT_VERSION) {
+            throw std::runtime_error("Unsupported binary environment version " + std::to_string(version));
+        }
+
+        const auto flags = reader.readByte();
+        std::optional<Config> envConfig;
+        if (flags & FLAG_CONFIG) {
+            envConfig = readConfig(reader);
+        } else if (config.has_value()) {
+            envConfig = config;
+        } else {
+            throw std::runtime_error("Binary environment contains no config");
+        }
+
+        auto team1 = readTeam(reader);
+        auto team2 = readTeam(reader);
+        auto quaffle = std::make_shared<Quaffle>(reader.readCell());
+        auto snitch = std::make_shared<Snitch>(reader.readCell());
+        std::array<std::shared_ptr<Bludger>, 2> bludgers{
+                std::make_shared<Bludger>(reader.readCell(), communication::messages::types::EntityId::BLUDGER1),
+                std::make_shared<Bludger>(reader.readCell(), communication::messages::types::EntityId::BLUDGER2)};
+        snitch->exists = (reader.readByte() & FLAG_SNITCH_EXISTS) != 0;
+
+        const auto numberOfCubes = reader.readVarint();
+        if (numberOfCubes > NUMBER_OF_CELLS * 8) {
+            throw std::runtime_error("Invalid number of cubes in binary environment");
+        }
+
+        std::deque<std::shared_ptr<CubeOfShit>> pileOfShit;
+        for (std::uint64_t i = 0; i < numberOfCubes; i++) {
+            pileOfShit.emplace_back(std::make_shared<CubeOfShit>(reader.readCell()));
+        }
+
+        const auto *spawned = reader.readBytes((numberOfCubes + 7) / 8);
+        for (std::size_t i = 0; i < pileOfShit.size(); i++) {
+            pileOfShit[i]->spawnedThisRound = (spawned[i / 8] >> (i % 8)) & 1u;
+        }
+
+        return std::make_shared<Environment>(std::move(envConfig.value()), std::move(team1), std::move(team2),
+                                             std::move(quaffle), std::move(snitch), std::move(bludgers),
+                                             std::move(pileOfShit));
+    }
+
+    auto toBinary(const Environment &env, bool includeConfig) -> std::vector<std::uint8_t> {
+        std::vector<std::uint8_t> ret;
+        ret.reserve(includeConfig ? 256 : 96);
+        BinaryWriter writer(ret);
+        writeEnvironment(writer, env, includeConfig);
+        return ret;
+    }
+
+    auto fromBinary(const std::vector<std::uint8_t> &data, const std::optional<Config> &config) ->
+        std::shared_ptr<Environment> {
+        BinaryReader reader(data.data(), data.size());
+        auto ret = readEnvironment(reader, config);
+        if (reader.remaining() != 0) {
+            throw std::runtime_error("Unexpected data behind binary environment");
+        }
+
+        return ret;
+    }
+}
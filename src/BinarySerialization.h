@@ -0,0 +1,156 @@
+/**
+ * @file BinarySerialization.h
+ * @date
+ * @brief Declaration of a compact, versioned binary encoding of the Environment.
+ */
+
+#ifndef SOPRAGAMELOGIC_BINARYSERIALIZATION_H
+#define SOPRAGAMELOGIC_BINARYSERIALIZATION_H
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "GameModel.h"
+
+namespace gameModel {
+
+    /**
+     * Current version of the binary Environment format. Layout of version 1, all integers little endian:
+     *  - magic 'Q' 'E', version byte, flags byte (bit 0: config present)
+     *  - config if present: varint maxRounds, the five game dynamics, ten foul detection and five extra turn
+     *    probabilities as IEEE 754 doubles in the order of the JSON keys
+     *  - left and right team: side byte, zigzag varint score, varint uses and varint banned count of every fan
+     *    type, seven players (seeker, keeper, beaters, chasers) as cell index byte, id byte and flags byte
+     *    (bits 0-2 broom, bit 3 fined, bit 4 knocked out)
+     *  - cell index bytes of quaffle, snitch and both bludgers, flags byte (bit 0: snitch exists)
+     *  - varint number of cubes of shit, their cell index bytes and a bitmap of spawnedThisRound
+     */
+    constexpr std::uint8_t BINARY_FORMAT_VERSION = 1;
+
+    /**
+     * Appends primitive values to a byte buffer
+     */
+    class BinaryWriter {
+    public:
+        /**
+         * main constructor for the BinaryWriter class.
+         * @param buffer buffer the values are appended to, has to outlive the writer
+         */
+        explicit BinaryWriter(std::vector<std::uint8_t> &buffer);
+
+        void writeByte(std::uint8_t value);
+        void writeUint32(std::uint32_t value);
+        void writeUint64(std::uint64_t value);
+        void writeVarint(std::uint64_t value);
+
+        /**
+         * Writes a signed value as zigzag encoded varint, small absolute values take a single byte
+         * @param value
+         */
+        void writeSignedVarint(std::int64_t value);
+        void writeDouble(double value);
+
+        /**
+         * Writes a position on the field as a single byte (see cellIndex)
+         * @param position
+         * @throws std::invalid_argument if the position is not on the field
+         */
+        void writeCell(const Position &position);
+        void writeBytes(const std::uint8_t *data, std::size_t size);
+
+        /**
+         * Getter
+         * @return number of bytes in the buffer
+         */
+        auto size() const -> std::size_t;
+
+    private:
+        std::vector<std::uint8_t> &buffer;
+    };
+
+    /**
+     * Reads primitive values written by a BinaryWriter
+     */
+    class BinaryReader {
+    public:
+        /**
+         * main constructor for the BinaryReader class.
+         * @param data first byte to read, has to outlive the reader
+         * @param size number of readable bytes
+         */
+        BinaryReader(const std::uint8_t *data, std::size_t size);
+
+        /**
+         * All read methods throw std::runtime_error if the data is truncated or malformed
+         */
+        auto readByte() -> std::uint8_t;
+        auto readUint32() -> std::uint32_t;
+        auto readUint64() -> std::uint64_t;
+        auto readVarint() -> std::uint64_t;
+        auto readSignedVarint() -> std::int64_t;
+        auto readDouble() -> double;
+        auto readCell() -> Position;
+
+        /**
+         * Returns a view of the next bytes and skips them
+         * @param size number of bytes
+         * @return pointer to the first byte
+         */
+        auto readBytes(std::size_t size) -> const std::uint8_t *;
+
+        /**
+         * Getter
+         * @return number of bytes not read yet
+         */
+        auto remaining() const -> std::size_t;
+
+        /**
+         * Getter
+         * @return number of bytes read so far
+         */
+        auto offset() const -> std::size_t;
+
+    private:
+        const std::uint8_t *data;
+        std::size_t size;
+        std::size_t pos = 0;
+
+        void require(std::size_t bytes) const;
+    };
+
+    /**
+     * Appends the binary encoding of an Environment
+     * @param writer destination
+     * @param env the Environment to encode
+     * @param includeConfig if false the Config is omitted and has to be provided when decoding
+     * @throws std::invalid_argument if an object is not on the field
+     */
+    void writeEnvironment(BinaryWriter &writer, const Environment &env, bool includeConfig = true);
+
+    /**
+     * Decodes an Environment written by writeEnvironment
+     * @param reader source, positioned behind the encoded Environment afterwards
+     * @param config used if the encoding does not contain a Config
+     * @throws std::runtime_error if the data is malformed, has an unknown version or neither the data nor the
+     * caller provide a Config
+     * @return the decoded Environment, equal to the encoded one
+     */
+    auto readEnvironment(BinaryReader &reader, const std::optional<Config> &config = std::nullopt) ->
+        std::shared_ptr<Environment>;
+
+    /**
+     * Encodes an Environment into a new buffer (see writeEnvironment)
+     */
+    auto toBinary(const Environment &env, bool includeConfig = true) -> std::vector<std::uint8_t>;
+
+    /**
+     * Decodes a buffer created by toBinary (see readEnvironment)
+     * @throws std::runtime_error additionally if there are bytes left behind the Environment
+     */
+    auto fromBinary(const std::vector<std::uint8_t> &data, const std::optional<Config> &config = std::nullopt) ->
+        std::shared_ptr<Environment>;
+}
+
+#endif //SOPRAGAMELOGIC_BINARYSERIALIZATION_H
@@ -0,0 +1,562 @@
+/**
+ * @file Delta.cpp
+ * @date
+ * @brief Implementation of change sets between two states of an Environment.
+ */
+
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+#include <string>
+#include "Delta.h"
+#include "conversions.h"
+
+namespace gameModel {
+
+    namespace {
+        constexpr std::array<std::uint8_t, 2> MAGIC = {'Q', 'D'};
+        constexpr std::uint8_t BROOM_MASK = 0x07u;
+        constexpr std::uint8_t NUMBER_OF_BROOMS = 5;
+        constexpr std::uint8_t FLAG_FINED = 1u << 3u;
+        constexpr std::uint8_t FLAG_KNOCKED_OUT = 1u << 4u;
+        constexpr std::uint8_t FLAG_HAS_SNITCH_EXISTS = 1u;
+        constexpr std::uint8_t FLAG_SNITCH_EXISTS = 1u << 1u;
+
+        constexpr std::array<InterferenceType, NUMBER_OF_INTERFERENCE_TYPES> fanTypes =
+                {InterferenceType::Teleport, InterferenceType::RangedAttack, InterferenceType::Impulse,
+                 InterferenceType::SnitchPush, InterferenceType::BlockCell};
+
+        auto getBalls(const Environment &env) -> std::array<std::shared_ptr<Ball>, 4> {
+            return {env.quaffle, env.snitch, env.bludgers[0], env.bludgers[1]};
+        }
+
+        auto getObject(const Environment &env, communication::messages::types::EntityId id) -> Object & {
+            if (gameLogic::conversions::isPlayer(id)) {
+                return env.getPlayerRef(id);
+            } else if (gameLogic::conversions::isBall(id)) {
+                return env.getBallRef(id);
+            }
+
+            throw std::invalid_argument("Delta contains an object that is neither a player nor a ball");
+        }
+
+        auto toId(std::uint8_t id) -> communication::messages::types::EntityId {
+            if (id > static_cast<std::uint8_t>(communication::messages::types::EntityId::QUAFFLE)) {
+                throw std::runtime_error("Invalid object id in binary delta");
+            }
+
+            return static_cast<communication::messages::types::EntityId>(id);
+        }
+
+        auto toBroom(std::uint8_t bits) -> communication::messages::types::Broom {
+            if ((bits & BROOM_MASK) >= NUMBER_OF_BROOMS) {
+                throw std::runtime_error("Invalid broom in binary delta");
+            }
+
+            return static_cast<communication::messages::types::Broom>(bits & BROOM_MASK);
+        }
+
+        auto toSide(std::uint64_t side) -> TeamSide {
+            if (side > static_cast<std::uint8_t>(TeamSide::RIGHT)) {
+                throw std::runtime_error("Invalid team side in delta");
+            }
+
+            return static_cast<TeamSide>(side);
+        }
+
+        auto toInterferenceType(std::uint64_t type) -> InterferenceType {
+            if (type >= NUMBER_OF_INTERFERENCE_TYPES) {
+                throw std::runtime_error("Invalid fan type in delta");
+            }
+
+            return static_cast<InterferenceType>(type);
+        }
+
+        auto readCount(BinaryReader &reader, std::size_t minimumSize) -> std::size_t {
+            auto count = reader.readVarint();
+            if (minimumSize > 0 && count > reader.remaining() / minimumSize) {
+                throw std::runtime_error("Binary data is truncated");
+            }
+
+            return static_cast<std::size_t>(count);
+        }
+    }
+
+    bool Delta::Move::operator==(const Move &other) const {
+        return id == other.id && target == other.target;
+    }
+
+    bool Delta::Move::operator!=(const Move &other) const {
+        return !(*this == other);
+    }
+
+    bool Delta::PlayerFlags::operator==(const PlayerFlags &other) const {
+        return id == other.id && isFined == other.isFined && knockedOut == other.knockedOut && broom == other.broom;
+    }
+
+    bool Delta::PlayerFlags::operator!=(const PlayerFlags &other) const {
+        return !(*this == other);
+    }
+
+    bool Delta::Score::operator==(const Score &other) const {
+        return side == other.side && score == other.score;
+    }
+
+    bool Delta::Score::operator!=(const Score &other) const {
+        return !(*this == other);
+    }
+
+    bool Delta::Fans::operator==(const Fans &other) const {
+        return side == other.side && type == other.type && uses == other.uses && banned == other.banned;
+    }
+
+    bool Delta::Fans::operator!=(const Fans &other) const {
+        return !(*this == other);
+    }
+
+    bool Delta::CubeFlag::operator==(const CubeFlag &other) const {
+        return index == other.index && spawnedThisRound == other.spawnedThisRound;
+    }
+
+    bool Delta::CubeFlag::operator!=(const CubeFlag &other) const {
+        return !(*this == other);
+    }
+
+    bool Delta::Cube::operator==(const Cube &other) const {
+        return position == other.position && spawnedThisRound == other.spawnedThisRound;
+    }
+
+    bool Delta::Cube::operator!=(const Cube &other) const {
+        return !(*this == other);
+    }
+
+    bool Delta::empty() const {
+        return moves.empty() && playerFlags.empty() && !snitchExists.has_value() && scores.empty() && fans.empty() &&
+               removedCubes.empty() && cubeFlags.empty() && addedCubes.empty();
+    }
+
+    bool Delta::operator==(const Delta &other) const {
+        return moves == other.moves && playerFlags == other.playerFlags && snitchExists == other.snitchExists &&
+               scores == other.scores && fans == other.fans && removedCubes == other.removedCubes &&
+               cubeFlags == other.cubeFlags && addedCubes == other.addedCubes;
+    }
+
+    bool Delta::operator!=(const Delta &other) const {
+        return !(*this == other);
+    }
+
+    auto diff(const Environment &from, const Environment &to) -> Delta {
+        Delta ret;
+        for (auto side : {TeamSide::LEFT, TeamSide::RIGHT}) {
+            const auto &oldTeam = *from.getTeam(side);
+            const auto &newTeam = *to.getTeam(side);
+            const auto oldPlayers = oldTeam.getAllPlayers();
+            const auto newPlayers = newTeam.getAllPlayers();
+            for (std::size_t i = 0; i < oldPlayers.size(); i++) {
+                const auto &oldPlayer = *oldPlayers[i];
+                const auto &newPlayer = *newPlayers[i];
+                if (oldPlayer.getId() != newPlayer.getId()) {
+                    throw std::invalid_argument("Teams of the Environments do not match");
+                }
+
+                if (oldPlayer.position != newPlayer.position) {
+                    ret.moves.push_back({newPlayer.getId(), newPlayer.position});
+                }
+
+                if (oldPlayer.isFined != newPlayer.isFined || oldPlayer.knockedOut != newPlayer.knockedOut ||
+                    oldPlayer.broom != newPlayer.broom) {
+                    ret.playerFlags.push_back({newPlayer.getId(), newPlayer.isFined, newPlayer.knockedOut,
+                                               newPlayer.broom});
+                }
+            }
+
+            if (oldTeam.score != newTeam.score) {
+                ret.scores.push_back({side, newTeam.score});
+            }
+
+            for (auto type : fanTypes) {
+                const auto uses = newTeam.fanblock.getUses(type);
+                const auto banned = newTeam.fanblock.getBannedCount(type);
+                if (oldTeam.fanblock.getUses(type) != uses || oldTeam.fanblock.getBannedCount(type) != banned) {
+                    ret.fans.push_back({side, type, uses, banned});
+                }
+            }
+        }
+
+        const auto oldBalls = getBalls(from);
+        const auto newBalls = getBalls(to);
+        for (std::size_t i = 0; i < oldBalls.size(); i++) {
+            if (oldBalls[i]->position != newBalls[i]->position) {
+                ret.moves.push_back({newBalls[i]->getId(), newBalls[i]->position});
+            }
+        }
+
+        if (from.snitch->exists != to.snitch->exists) {
+            ret.snitchExists = to.snitch->exists;
+        }
+
+        // cubes are only appended and removed, so matching both piles in order finds the kept ones
+        std::size_t next = 0;
+        std::size_t kept = 0;
+        for (std::size_t i = 0; i < from.pileOfShit.size(); i++) {
+            const auto &oldCube = *from.pileOfShit[i];
+            if (next < to.pileOfShit.size() && to.pileOfShit[next]->position == oldCube.position) {
+                if (to.pileOfShit[next]->spawnedThisRound != oldCube.spawnedThisRound) {
+                    ret.cubeFlags.push_back({kept, to.pileOfShit[next]->spawnedThisRound});
+                }
+
+                next++;
+                kept++;
+            } else {
+                ret.removedCubes.push_back(i);
+            }
+        }
+
+        for (; next < to.pileOfShit.size(); next++) {
+            ret.addedCubes.push_back({to.pileOfShit[next]->position, to.pileOfShit[next]->spawnedThisRound});
+        }
+
+        return ret;
+    }
+
+    void apply(Environment &env, const Delta &delta) {
+        for (const auto &move : delta.moves) {
+            getObject(env, move.id).position = move.target;
+        }
+
+        for (const auto &flags : delta.playerFlags) {
+            auto &player = env.getPlayerRef(flags.id);
+            player.isFined = flags.isFined;
+            player.knockedOut = flags.knockedOut;
+            player.broom = flags.broom;
+        }
+
+        if (delta.snitchExists.has_value()) {
+            env.snitch->exists = delta.snitchExists.value();
+        }
+
+        for (const auto &score : delta.scores) {
+            env.getTeam(score.side)->score = score.score;
+        }
+
+        for (auto side : {TeamSide::LEFT, TeamSide::RIGHT}) {
+            auto team = env.getTeam(side);
+            std::array<int, NUMBER_OF_INTERFERENCE_TYPES> uses{};
+            std::array<int, NUMBER_OF_INTERFERENCE_TYPES> banned{};
+            for (std::size_t i = 0; i < fanTypes.size(); i++) {
+                uses[i] = team->fanblock.getUses(fanTypes[i]);
+                banned[i] = team->fanblock.getBannedCount(fanTypes[i]);
+            }
+
+            bool changed = false;
+            for (const auto &fans : delta.fans) {
+                if (fans.side == side) {
+                    auto i = static_cast<std::size_t>(std::find(fanTypes.begin(), fanTypes.end(), fans.type) -
+                                                      fanTypes.begin());
+                    uses[i] = fans.uses;
+                    banned[i] = fans.banned;
+                    changed = true;
+                }
+            }
+
+            if (changed) {
+                Fanblock fanblock{uses[0] + banned[0], uses[1] + banned[1], uses[2] + banned[2], uses[3] + banned[3],
+                                  uses[4] + banned[4]};
+                for (std::size_t i = 0; i < fanTypes.size(); i++) {
+                    for (int j = 0; j < banned[i]; j++) {
+                        fanblock.banFan(fanTypes[i]);
+                    }
+                }
+
+                team->fanblock = std::move(fanblock);
+            }
+        }
+
+        for (auto it = delta.removedCubes.rbegin(); it != delta.removedCubes.rend(); it++) {
+            if (*it >= env.pileOfShit.size()) {
+                throw std::invalid_argument("Delta removes a cube that does not exist");
+            }
+
+            env.pileOfShit.erase(env.pileOfShit.begin() + static_cast<long>(*it));
+        }
+
+        for (const auto &flag : delta.cubeFlags) {
+            if (flag.index >= env.pileOfShit.size()) {
+                throw std::invalid_argument("Delta changes a cube that does not exist");
+            }
+
+            env.pileOfShit[flag.index]->spawnedThisRound = flag.spawnedThisRound;
+        }
+
+        for (const auto &cube : delta.addedCubes) {
+            env.pileOfShit.emplace_back(std::make_shared<CubeOfShit>(cube.position));
+            env.pileOfShit.back()->spawnedThisRound = cube.spawnedThisRound;
+        }
+    }
+
+    void writeDelta(BinaryWriter &writer, const Delta &delta) {
+        writer.writeBytes(MAGIC.data(), MAGIC.size());
+        writer.writeByte(BINARY_DELTA_VERSION);
+
+        writer.writeVarint(delta.moves.size());
+        for (const auto &move : delta.moves) {
+            writer.writeByte(static_cast<std::uint8_t>(move.id));
+            writer.writeCell(move.target);
+        }
+
+        writer.writeVarint(delta.playerFlags.size());
+        for (const auto &flags : delta.playerFlags) {
+            writer.writeByte(static_cast<std::uint8_t>(flags.id));
+            auto bits = static_cast<std::uint8_t>(static_cast<std::uint8_t>(flags.broom) & BROOM_MASK);
+            bits |= flags.isFined ? FLAG_FINED : 0;
+            bits |= flags.knockedOut ? FLAG_KNOCKED_OUT : 0;
+            writer.writeByte(bits);
+        }
+
+        std::uint8_t snitch = 0;
+        if (delta.snitchExists.has_value()) {
+            snitch = FLAG_HAS_SNITCH_EXISTS | (delta.snitchExists.value() ? FLAG_SNITCH_EXISTS : 0);
+        }
+
+        writer.writeByte(snitch);
+        writer.writeVarint(delta.scores.size());
+        for (const auto &score : delta.scores) {
+            writer.writeByte(static_cast<std::uint8_t>(score.side));
+            writer.writeSignedVarint(score.score);
+        }
+
+        writer.writeVarint(delta.fans.size());
+        for (const auto &fans : delta.fans) {
+            writer.writeByte(static_cast<std::uint8_t>(static_cast<std::uint8_t>(fans.side) << 4u |
+                                                       static_cast<std::uint8_t>(fans.type)));
+            writer.writeVarint(static_cast<std::uint64_t>(fans.uses));
+            writer.writeVarint(static_cast<std::uint64_t>(fans.banned));
+        }
+
+        // ascending indices are stored as gaps to keep them small
+        writer.writeVarint(delta.removedCubes.size());
+        std::size_t previous = 0;
+        for (auto index : delta.removedCubes) {
+            writer.writeVarint(index - previous);
+            previous = index;
+        }
+
+        writer.writeVarint(delta.cubeFlags.size());
+        for (const auto &flag : delta.cubeFlags) {
+            writer.writeVarint(static_cast<std::uint64_t>(flag.index) << 1u | (flag.spawnedThisRound ? 1u : 0u));
+        }
+
+        writer.writeVarint(delta.addedCubes.size());
+        std::vector<std::uint8_t> spawned((delta.addedCubes.size() + 7) / 8, 0);
+        for (std::size_t i = 0; i < delta.addedCubes.size(); i++) {
+            writer.writeCell(delta.addedCubes[i].position);
+            if (delta.addedCubes[i].spawnedThisRound) {
+                spawned[i / 8] |= static_cast<std::uint8_t>(1u << (i % 8));
+            }
+        }
+
+        writer.writeBytes(spawned.data(), spawned.size());
+    }
+
+    auto readDelta(BinaryReader &reader) -> Delta {
+        const auto *magic = reader.readBytes(MAGIC.size());
+        if (!std::equal(MAGIC.begin(), MAGIC.end(), magic)) {
+            throw std::runtime_error("Data is no binary delta");
+        }
+
+        const auto version = reader.readByte();
+        if (version != BINARY_DELTA_VERSION) {
+            throw std::runtime_error("Unsupported binary delta version " + std::to_string(version));
+        }
+
+        Delta ret;
+        ret.moves.resize(readCount(reader, 2));
+        for (auto &move : ret.moves) {
+            move.id = toId(reader.readByte());
+            move.target = reader.readCell();
+        }
+
+        ret.playerFlags.resize(readCount(reader, 2));
+        for (auto &flags : ret.playerFlags) {
+            flags.id = toId(reader.readByte());
+            if (!gameLogic::conversions::isPlayer(flags.id)) {
+                throw std::runtime_error("Invalid player id in binary delta");
+            }
+
+            const auto bits = reader.readByte();
+            flags.broom = toBroom(bits);
+            flags.isFined = (bits & FLAG_FINED) != 0;
+            flags.knockedOut = (bits & FLAG_KNOCKED_OUT) != 0;
+        }
+
+        const auto snitch = reader.readByte();
+        if (snitch & FLAG_HAS_SNITCH_EXISTS) {
+            ret.snitchExists = (snitch & FLAG_SNITCH_EXISTS) != 0;
+        }
+
+        ret.scores.resize(readCount(reader, 2));
+        for (auto &score : ret.scores) {
+            score.side = toSide(reader.readByte());
+            score.score = static_cast<int>(reader.readSignedVarint());
+        }
+
+        ret.fans.resize(readCount(reader, 3));
+        for (auto &fans : ret.fans) {
+            const auto key = reader.readByte();
+            fans.side = toSide(key >> 4u);
+            fans.type = toInterferenceType(key & 0x0Fu);
+            fans.uses = static_cast<int>(reader.readVarint());
+            fans.banned = static_cast<int>(reader.readVarint());
+        }
+
+        ret.removedCubes.resize(readCount(reader, 1));
+        std::size_t previous = 0;
+        for (auto &index : ret.removedCubes) {
+            index = previous + static_cast<std::size_t>(reader.readVarint());
+            previous = index;
+        }
+
+        ret.cubeFlags.resize(readCount(reader, 1));
+        for (auto &flag : ret.cubeFlags) {
+            const auto value = reader.readVarint();
+            flag.index = static_cast<std::size_t>(value >> 1u);
+            flag.spawnedThisRound = (value & 1u) != 0;
+        }
+
+        ret.addedCubes.resize(readCount(reader, 1));
+        for (auto &cube : ret.addedCubes) {
+            cube.position = reader.readCell();
+        }
+
+        const auto *spawned = reader.readBytes((ret.addedCubes.size() + 7) / 8);
+        for (std::size_t i = 0; i < ret.addedCubes.size(); i++) {
+            ret.addedCubes[i].spawnedThisRound = (spawned[i / 8] >> (i % 8)) & 1u;
+        }
+
+        return ret;
+    }
+
+    auto toBinary(const Delta &delta) -> std::vector<std::uint8_t> {
+        std::vector<std::uint8_t> ret;
+        BinaryWriter writer(ret);
+        writeDelta(writer, delta);
+        return ret;
+    }
+
+    auto deltaFromBinary(const std::vector<std::uint8_t> &data) -> Delta {
+        BinaryReader reader(data.data(), data.size());
+        auto ret = readDelta(reader);
+        if (reader.remaining() != 0) {
+            throw std::runtime_error("Unexpected data behind binary delta");
+        }
+
+        return ret;
+    }
+
+    void to_json(nlohmann::json &j, const Delta &delta) {
+        j = nlohmann::json::object();
+        if (!delta.moves.empty()) {
+            auto &moves = j["moves"] = nlohmann::json::array();
+            for (const auto &move : delta.moves) {
+                moves.push_back({{"id", move.id}, {"position", move.target}});
+            }
+        }
+
+        if (!delta.playerFlags.empty()) {
+            auto &players = j["players"] = nlohmann::json::array();
+            for (const auto &flags : delta.playerFlags) {
+                players.push_back({{"id", flags.id}, {"fined", flags.isFined}, {"knockedOut", flags.knockedOut},
+                                   {"broom", flags.broom}});
+            }
+        }
+
+        if (delta.snitchExists.has_value()) {
+            j["snitchExists"] = delta.snitchExists.value();
+        }
+
+        if (!delta.scores.empty()) {
+            auto &scores = j["scores"] = nlohmann::json::array();
+            for (const auto &score : delta.scores) {
+                scores.push_back({{"side", score.side}, {"score", score.score}});
+            }
+        }
+
+        if (!delta.fans.empty()) {
+            auto &fans = j["fans"] = nlohmann::json::array();
+            for (const auto &fan : delta.fans) {
+                fans.push_back({{"side", fan.side}, {"type", static_cast<int>(fan.type)}, {"uses", fan.uses},
+                                {"banned", fan.banned}});
+            }
+        }
+
+        if (!delta.removedCubes.empty()) {
+            j["removedCubes"] = delta.removedCubes;
+        }
+
+        if (!delta.cubeFlags.empty()) {
+            auto &flags = j["cubeFlags"] = nlohmann::json::array();
+            for (const auto &flag : delta.cubeFlags) {
+                flags.push_back({{"index", flag.index}, {"spawnedThisRound", flag.spawnedThisRound}});
+            }
+        }
+
+        if (!delta.addedCubes.empty()) {
+            auto &cubes = j["addedCubes"] = nlohmann::json::array();
+            for (const auto &cube : delta.addedCubes) {
+                cubes.push_back({{"position", cube.position}, {"spawnedThisRound", cube.spawnedThisRound}});
+            }
+        }
+    }
+
+    void from_json(const nlohmann::json &j, Delta &delta) {
+        delta = {};
+        auto forEach = [&j](const char *key, const auto &function) {
+            auto it = j.find(key);
+            if (it != j.end()) {
+                for (const auto &entry : *it) {
+                    function(entry);
+                }
+            }
+        };
+
+        forEach("moves", [&delta](const nlohmann::json &entry) {
+            delta.moves.push_back({entry.at("id").get<communication::messages::types::EntityId>(),
+                                   entry.at("position").get<Position>()});
+        });
+
+        forEach("players", [&delta](const nlohmann::json &entry) {
+            delta.playerFlags.push_back({entry.at("id").get<communication::messages::types::EntityId>(),
+                                         entry.at("fined").get<bool>(), entry.at("knockedOut").get<bool>(),
+                                         entry.at("broom").get<communication::messages::types::Broom>()});
+        });
+
+        auto snitchExists = j.find("snitchExists");
+        if (snitchExists != j.end()) {
+            delta.snitchExists = snitchExists->get<bool>();
+        }
+
+        forEach("scores", [&delta](const nlohmann::json &entry) {
+            delta.scores.push_back({entry.at("side").get<TeamSide>(), entry.at("score").get<int>()});
+        });
+
+        forEach("fans", [&delta](const nlohmann::json &entry) {
+            delta.fans.push_back({entry.at("side").get<TeamSide>(),
+                                  toInterferenceType(entry.at("type").get<std::uint64_t>()),
+                                  entry.at("uses").get<int>(), entry.at("banned").get<int>()});
+        });
+
+        forEach("removedCubes", [&delta](const nlohmann::json &entry) {
+            delta.removedCubes.push_back(entry.get<std::size_t>());
+        });
+
+        forEach("cubeFlags", [&delta](const nlohmann::json &entry) {
+            delta.cubeFlags.push_back({entry.at("index").get<std::size_t>(),
+                                       entry.at("spawnedThisRound").get<bool>()});
+        });
+
+        forEach("addedCubes", [&delta](const nlohmann::json &entry) {
+            delta.addedCubes.push_back({entry.at("position").get<Position>(),
+                                        entry.at("spawnedThisRound").get<bool>()});
+        });
+    }
+}
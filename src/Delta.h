@@ -0,0 +1,167 @@
+/**
+ * @file Delta.h
+ * @date
+ * @brief Declaration of change sets between two states of an Environment.
+ */
+
+#ifndef SOPRAGAMELOGIC_DELTA_H
+#define SOPRAGAMELOGIC_DELTA_H
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "GameModel.h"
+#include "BinarySerialization.h"
+
+namespace gameModel {
+
+    /**
+     * Current version of the binary Delta format
+     */
+    constexpr std::uint8_t BINARY_DELTA_VERSION = 1;
+
+    /**
+     * Minimal set of changes transforming one state of an Environment into another. Objects and flags are stored
+     * with their new values, the pile of shit as removed, changed and appended cubes. The Config is not part of a
+     * Delta.
+     */
+    struct Delta {
+        /**
+         * New position of a player or ball
+         */
+        struct Move {
+            communication::messages::types::EntityId id;
+            Position target;
+
+            bool operator==(const Move &other) const;
+            bool operator!=(const Move &other) const;
+        };
+
+        /**
+         * New flags of a player
+         */
+        struct PlayerFlags {
+            communication::messages::types::EntityId id;
+            bool isFined = false;
+            bool knockedOut = false;
+            communication::messages::types::Broom broom{};
+
+            bool operator==(const PlayerFlags &other) const;
+            bool operator!=(const PlayerFlags &other) const;
+        };
+
+        /**
+         * New score of a team
+         */
+        struct Score {
+            TeamSide side;
+            int score = 0;
+
+            bool operator==(const Score &other) const;
+            bool operator!=(const Score &other) const;
+        };
+
+        /**
+         * New number of usable and banned fans of a type
+         */
+        struct Fans {
+            TeamSide side;
+            InterferenceType type;
+            int uses = 0;
+            int banned = 0;
+
+            bool operator==(const Fans &other) const;
+            bool operator!=(const Fans &other) const;
+        };
+
+        /**
+         * New spawnedThisRound flag of a cube that is kept
+         */
+        struct CubeFlag {
+            std::size_t index; ///< index in the pile after removing the cubes in removedCubes
+            bool spawnedThisRound;
+
+            bool operator==(const CubeFlag &other) const;
+            bool operator!=(const CubeFlag &other) const;
+        };
+
+        /**
+         * Cube appended to the pile
+         */
+        struct Cube {
+            Position position;
+            bool spawnedThisRound;
+
+            bool operator==(const Cube &other) const;
+            bool operator!=(const Cube &other) const;
+        };
+
+        std::vector<Move> moves;
+        std::vector<PlayerFlags> playerFlags;
+        std::optional<bool> snitchExists;
+        std::vector<Score> scores;
+        std::vector<Fans> fans;
+        std::vector<std::size_t> removedCubes; ///< ascending indices in the old pile
+        std::vector<CubeFlag> cubeFlags;
+        std::vector<Cube> addedCubes;
+
+        /**
+         * Checks if the Delta contains any changes
+         * @return true if both states are equal, false otherwise
+         */
+        bool empty() const;
+
+        bool operator==(const Delta &other) const;
+        bool operator!=(const Delta &other) const;
+    };
+
+    /**
+     * Computes the changes from one state to another
+     * @param from the old state
+     * @param to the new state, has to contain the same teams (sides and players) as from
+     * @throws std::invalid_argument if the teams of the states do not match
+     * @return Delta with apply(from, delta) == to
+     */
+    auto diff(const Environment &from, const Environment &to) -> Delta;
+
+    /**
+     * Applies changes computed by diff in place
+     * @param env state equal to the old state the Delta was computed from
+     * @param delta the changes
+     * @throws std::invalid_argument if the Delta does not fit the Environment
+     */
+    void apply(Environment &env, const Delta &delta);
+
+    /**
+     * Appends the binary encoding of a Delta (see BinaryWriter)
+     * @param writer destination
+     * @param delta
+     * @throws std::invalid_argument if a position is not on the field
+     */
+    void writeDelta(BinaryWriter &writer, const Delta &delta);
+
+    /**
+     * Decodes a Delta written by writeDelta
+     * @param reader source, positioned behind the Delta afterwards
+     * @throws std::runtime_error if the data is malformed or has an unknown version
+     * @return the decoded Delta
+     */
+    auto readDelta(BinaryReader &reader) -> Delta;
+
+    /**
+     * Encodes a Delta into a new buffer (see writeDelta)
+     */
+    auto toBinary(const Delta &delta) -> std::vector<std::uint8_t>;
+
+    /**
+     * Decodes a buffer created by toBinary(const Delta &) (see readDelta)
+     * @throws std::runtime_error additionally if there are bytes left behind the Delta
+     */
+    auto deltaFromBinary(const std::vector<std::uint8_t> &data) -> Delta;
+
+    void to_json(nlohmann::json &j, const Delta &delta);
+    void from_json(const nlohmann::json &j, Delta &delta);
+}
+
+#endif //SOPRAGAMELOGIC_DELTA_H
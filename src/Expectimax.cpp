@@ -0,0 +1,379 @@
+/**
+ * @file Expectimax.cpp
+ * @date
+ * @brief Implementation of an expectimax search over the outcomes of Actions.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include "Expectimax.h"
+#include "conversions.h"
+
+namespace gameController {
+
+    namespace {
+        constexpr unsigned int CLOCK_CHECK_INTERVAL = 1024;
+
+        auto splitMix64(std::uint64_t x) -> std::uint64_t {
+            x += 0x9E3779B97F4A7C15ull;
+            x = (x ^ (x >> 30u)) * 0xBF58476D1CE4E5B9ull;
+            x = (x ^ (x >> 27u)) * 0x94D049BB133111EBull;
+            return x ^ (x >> 31u);
+        }
+
+        /**
+         * All actions of a player in one ply, indexed moves first, then shots, then wresting
+         */
+        struct Candidates {
+            std::vector<Move> moves;
+            std::vector<Shot> shots;
+            std::optional<WrestQuaffle> wrest;
+
+            auto size() const -> std::size_t {
+                return moves.size() + shots.size() + (wrest.has_value() ? 1 : 0);
+            }
+
+            auto operator[](std::size_t index) const -> const Action & {
+                if (index < moves.size()) {
+                    return moves[index];
+                } else if (index < moves.size() + shots.size()) {
+                    return shots[index - moves.size()];
+                }
+
+                return wrest.value();
+            }
+
+            auto copy(std::size_t index) const -> std::shared_ptr<Action> {
+                if (index < moves.size()) {
+                    return std::make_shared<Move>(moves[index]);
+                } else if (index < moves.size() + shots.size()) {
+                    return std::make_shared<Shot>(shots[index - moves.size()]);
+                }
+
+                return std::make_shared<WrestQuaffle>(wrest.value());
+            }
+        };
+
+        auto generateCandidates(const std::shared_ptr<gameModel::Environment> &env,
+                const std::shared_ptr<gameModel::Player> &actor) -> Candidates {
+            Candidates ret;
+            if (actor->isFined || actor->knockedOut) {
+                return ret;
+            }
+
+            ret.moves = getAllPossibleMoves(actor, env);
+            ret.moves.erase(std::remove_if(ret.moves.begin(), ret.moves.end(), [](const Move &move) {
+                return move.check() == ActionCheckResult::Impossible;
+            }), ret.moves.end());
+
+            auto type = getPossibleBallActionType(actor, env);
+            if (type == ActionType::Throw) {
+                ret.shots = getAllConstrainedShots(actor, env);
+                ret.shots.erase(std::remove_if(ret.shots.begin(), ret.shots.end(), [](const Shot &shot) {
+                    return shot.check() == ActionCheckResult::Impossible;
+                }), ret.shots.end());
+            } else if (type == ActionType::Wrest) {
+                ret.wrest.emplace(env, std::static_pointer_cast<gameModel::Chaser>(actor), env->quaffle->position);
+            }
+
+            return ret;
+        }
+    }
+
+    auto scoreEvaluation(double scale) -> Evaluation {
+        return [scale](const gameModel::Environment &env, gameModel::TeamSide side) {
+            auto diff = env.team1->score - env.team2->score;
+            return std::tanh((side == gameModel::TeamSide::LEFT ? diff : -diff) / scale);
+        };
+    }
+
+    Expectimax::Expectimax(Evaluation evaluation, double minValue, double maxValue, ChancePruning pruning,
+            std::size_t tableEntries) : evaluation(std::move(evaluation)), minValue(minValue), maxValue(maxValue),
+            pruning(pruning), table(tableEntries) {
+        if (minValue >= maxValue) {
+            throw std::invalid_argument("minValue has to be smaller than maxValue");
+        }
+    }
+
+    auto Expectimax::search(const std::shared_ptr<gameModel::Environment> &rootEnv,
+            const std::vector<communication::messages::types::EntityId> &order,
+            const SearchLimits &limits) -> SearchResult {
+        if (order.empty() || !std::all_of(order.begin(), order.end(), gameLogic::conversions::isPlayer)) {
+            throw std::invalid_argument("Turn order has to consist of players");
+        }
+
+        gameModel::ScopedCloneResource cloneScope(arena);
+        env = rootEnv->clone();
+        hash = env->getHash();
+        turnOrder = order;
+        rootSide = gameLogic::conversions::idToSide(order.front());
+        std::uint64_t orderKey = 0;
+        for (const auto &id : order) {
+            orderKey = splitMix64(orderKey ^ static_cast<std::uint64_t>(id));
+        }
+
+        plyKeys.clear();
+        for (std::size_t i = 0; i < order.size(); i++) {
+            plyKeys.emplace_back(splitMix64(orderKey + i));
+        }
+
+        table.newSearch();
+        deadline = std::chrono::steady_clock::now() + limits.budget;
+        aborted = false;
+        nodes = 0;
+
+        SearchResult result;
+        std::optional<std::size_t> best;
+        for (unsigned int depth = 1; depth <= limits.maxDepth; depth++) {
+            mayAbort = depth > 1;
+            std::size_t bestIndex = std::numeric_limits<std::size_t>::max();
+            auto value = decision(depth, 0, minValue, maxValue, &bestIndex);
+            if (aborted) {
+                break;
+            }
+
+            result.value = value;
+            result.depth = depth;
+            if (bestIndex != std::numeric_limits<std::size_t>::max()) {
+                best = bestIndex;
+            }
+
+            if (std::chrono::steady_clock::now() >= deadline) {
+                break;
+            }
+        }
+
+        result.nodes = nodes;
+        if (best.has_value()) {
+            result.bestAction = generateCandidates(rootEnv, rootEnv->getPlayerById(order.front())).copy(best.value());
+        }
+
+        env.reset();
+        arena.release();
+        return result;
+    }
+
+    auto Expectimax::decision(unsigned int depth, unsigned int ply, double alpha, double beta,
+            std::size_t *bestIndex) -> double {
+        nodes++;
+        if (mayAbort && nodes % CLOCK_CHECK_INTERVAL == 0 && std::chrono::steady_clock::now() >= deadline) {
+            aborted = true;
+        }
+
+        if (aborted) {
+            return 0;
+        }
+
+        if (depth == 0) {
+            return evaluate();
+        }
+
+        const auto key = hash ^ plyKeys[ply % plyKeys.size()];
+        auto entry = table.probe(key);
+        if (entry.has_value() && bestIndex == nullptr && entry->depth >= depth) {
+            if (entry->bound == Bound::Exact ||
+                (entry->bound == Bound::Lower && entry->value >= beta) ||
+                (entry->bound == Bound::Upper && entry->value <= alpha)) {
+                return entry->value;
+            }
+        }
+
+        auto candidates = generateCandidates(env, getActor(ply));
+        if (candidates.size() == 0) {
+            return decision(depth - 1, ply + 1, alpha, beta);
+        }
+
+        std::vector<std::size_t> order(candidates.size());
+        for (std::size_t i = 0; i < order.size(); i++) {
+            order[i] = i;
+        }
+
+        if (entry.has_value() && entry->bestAction < order.size()) {
+            std::swap(order[0], order[entry->bestAction]);
+        }
+
+        const bool maximizing = isMaximizing(ply);
+        const double alphaOrig = alpha;
+        const double betaOrig = beta;
+        double best = maximizing ? -std::numeric_limits<double>::infinity() : std::numeric_limits<double>::infinity();
+        std::size_t bestCandidate = order.front();
+        for (auto index : order) {
+            auto value = chance(candidates[index], depth - 1, ply, alpha, beta);
+            if (aborted) {
+                return 0;
+            }
+
+            if (maximizing ? value > best : value < best) {
+                best = value;
+                bestCandidate = index;
+            }
+
+            if (maximizing) {
+                alpha = std::max(alpha, value);
+            } else {
+                beta = std::min(beta, value);
+            }
+
+            if (alpha >= beta) {
+                break;
+            }
+        }
+
+        auto bound = Bound::Exact;
+        if (best <= alphaOrig) {
+            bound = Bound::Upper;
+        } else if (best >= betaOrig) {
+            bound = Bound::Lower;
+        }
+
+        table.store(key, {best, bound, static_cast<std::uint8_t>(std::min(depth, 255u)),
+                          static_cast<std::uint16_t>(std::min<std::size_t>(bestCandidate, TranspositionEntry::NO_ACTION))});
+        if (bestIndex != nullptr) {
+            *bestIndex = bestCandidate;
+        }
+
+        return best;
+    }
+
+    auto Expectimax::chance(const Action &action, unsigned int depth, unsigned int ply, double alpha,
+            double beta) -> double {
+        auto outcomes = action.getOutcomes();
+        std::stable_sort(outcomes.begin(), outcomes.end(), [](const ActionOutcome &a, const ActionOutcome &b) {
+            return a.probability > b.probability;
+        });
+
+        auto searchOutcome = [this, &depth, &ply](const ActionOutcome &outcome, const auto &search) {
+            auto record = applyOutcome(env, outcome);
+            const auto oldHash = hash;
+            hash = updateHash(hash, *env, record);
+            auto value = search(depth, ply + 1);
+            undoOutcome(env, record);
+            hash = oldHash;
+            return value;
+        };
+
+        if (pruning == ChancePruning::None) {
+            double sum = 0;
+            for (const auto &outcome : outcomes) {
+                sum += outcome.probability * searchOutcome(outcome, [this](unsigned int d, unsigned int p) {
+                    return decision(d, p, minValue, maxValue);
+                });
+                if (aborted) {
+                    return 0;
+                }
+            }
+
+            return sum;
+        }
+
+        std::vector<double> lower(outcomes.size(), minValue);
+        std::vector<double> upper(outcomes.size(), maxValue);
+        double restLower = 0;
+        double restUpper = 0;
+        for (const auto &outcome : outcomes) {
+            restLower += outcome.probability * minValue;
+            restUpper += outcome.probability * maxValue;
+        }
+
+        // Star2: the value of a single successor is a lower bound of a max node and an upper bound of a min node
+        if (pruning == ChancePruning::Star2 && depth > 0) {
+            const bool childMaximizing = isMaximizing(ply + 1);
+            for (std::size_t i = 0; i < outcomes.size(); i++) {
+                auto value = searchOutcome(outcomes[i], [this](unsigned int d, unsigned int p) {
+                    return probe(d, p);
+                });
+                if (aborted) {
+                    return 0;
+                }
+
+                if (childMaximizing) {
+                    restLower += outcomes[i].probability * (value - lower[i]);
+                    lower[i] = value;
+                    if (restLower >= beta) {
+                        return restLower;
+                    }
+                } else {
+                    restUpper += outcomes[i].probability * (value - upper[i]);
+                    upper[i] = value;
+                    if (restUpper <= alpha) {
+                        return restUpper;
+                    }
+                }
+            }
+        }
+
+        // Star1
+        double known = 0;
+        for (std::size_t i = 0; i < outcomes.size(); i++) {
+            const auto p = outcomes[i].probability;
+            restLower -= p * lower[i];
+            restUpper -= p * upper[i];
+            if (p <= 0) {
+                continue;
+            }
+
+            const double childAlpha = (alpha - known - restUpper) / p;
+            const double childBeta = (beta - known - restLower) / p;
+            if (lower[i] >= childBeta) {
+                return known + p * lower[i] + restLower;
+            } else if (upper[i] <= childAlpha) {
+                return known + p * upper[i] + restUpper;
+            }
+
+            double value = lower[i];
+            if (lower[i] < upper[i]) {
+                const double a = std::max(childAlpha, lower[i]);
+                const double b = std::min(childBeta, upper[i]);
+                value = searchOutcome(outcomes[i], [this, a, b](unsigned int d, unsigned int pl) {
+                    return decision(d, pl, a, b);
+                });
+                if (aborted) {
+                    return 0;
+                }
+            }
+
+            if (value <= childAlpha) {
+                return known + p * value + restUpper;
+            } else if (value >= childBeta) {
+                return known + p * value + restLower;
+            }
+
+            known += p * value;
+        }
+
+        return known;
+    }
+
+    auto Expectimax::probe(unsigned int depth, unsigned int ply) -> double {
+        if (depth == 0) {
+            return evaluate();
+        }
+
+        auto candidates = generateCandidates(env, getActor(ply));
+        if (candidates.size() == 0) {
+            return decision(depth - 1, ply + 1, minValue, maxValue);
+        }
+
+        std::size_t first = 0;
+        auto entry = table.probe(hash ^ plyKeys[ply % plyKeys.size()]);
+        if (entry.has_value() && entry->bestAction < candidates.size()) {
+            first = entry->bestAction;
+        }
+
+        return chance(candidates[first], depth - 1, ply, minValue, maxValue);
+    }
+
+    auto Expectimax::evaluate() const -> double {
+        return std::clamp(evaluation(*env, rootSide), minValue, maxValue);
+    }
+
+    auto Expectimax::getActor(unsigned int ply) const -> std::shared_ptr<gameModel::Player> {
+        return env->getPlayerById(turnOrder[ply % turnOrder.size()]);
+    }
+
+    bool Expectimax::isMaximizing(unsigned int ply) const {
+        return gameLogic::conversions::idToSide(turnOrder[ply % turnOrder.size()]) == rootSide;
+    }
+}
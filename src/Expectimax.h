@@ -0,0 +1,125 @@
+/**
+ * @file Expectimax.h
+ * @date
+ * @brief Declaration of an expectimax search over the outcomes of Actions.
+ */
+
+#ifndef SOPRAGAMELOGIC_EXPECTIMAX_H
+#define SOPRAGAMELOGIC_EXPECTIMAX_H
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+#include "GameModel.h"
+#include "GameController.h"
+#include "TranspositionTable.h"
+
+namespace gameController {
+
+    /**
+     * Values a state from the point of view of a team
+     */
+    using Evaluation = std::function<double(const gameModel::Environment &, gameModel::TeamSide)>;
+
+    /**
+     * Evaluation based on the score difference, bounded to [-1, 1]
+     * @param scale score difference resulting in a value of tanh(1)
+     * @return tanh((own score - opponent score) / scale)
+     */
+    auto scoreEvaluation(double scale = SNITCH_POINTS) -> Evaluation;
+
+    /**
+     * Limits of a single search
+     */
+    struct SearchLimits {
+        unsigned int maxDepth = 64; ///< maximum number of plies
+        std::chrono::milliseconds budget{1000}; ///< wall clock time after which the search is stopped
+    };
+
+    /**
+     * Result of a search
+     */
+    struct SearchResult {
+        std::shared_ptr<Action> bestAction; ///< best action of the first actor operating on the searched Environment, nullptr if the actor cannot act
+        double value = 0; ///< expected value of the best action for the team of the first actor
+        unsigned int depth = 0; ///< depth of the deepest completed iteration
+        std::uint64_t nodes = 0; ///< number of visited decision nodes
+    };
+
+    /**
+     * Expectimax search with alpha beta pruning at decision nodes and Star1 / Star2 pruning at chance nodes
+     * (Ballard, 1983). Every ply one player chooses a Move, Shot or WrestQuaffle from the generators in
+     * GameController.h, followed by a chance node over the outcomes of the Action (see Action::getOutcomes).
+     * Outcomes are applied in place and reverted with undoOutcome, states are cached in a TranspositionTable.
+     * The search deepens iteratively until the depth limit or the time budget is reached. Environments cloned during
+     * a search are allocated from an arena of the engine which is released as a whole once the search is done.
+     */
+    class Expectimax {
+    public:
+        /**
+         * Pruning at chance nodes
+         */
+        enum class ChancePruning {
+            None, ///< plain expectimax, every outcome is searched with the full window
+            Star1, ///< cut off once the weighted sum of known values and bounds leaves the window
+            Star2 ///< Star1 with a probing phase tightening the bounds before the outcomes are searched
+        };
+
+        /**
+         * main constructor for the Expectimax class.
+         * @param evaluation evaluation of the leaves, clamped to [minValue, maxValue]
+         * @param minValue lower bound of all evaluations
+         * @param maxValue upper bound of all evaluations
+         * @param pruning pruning at chance nodes
+         * @param tableEntries number of slots of the transposition table
+         * @throws std::invalid_argument if minValue is not smaller than maxValue
+         */
+        Expectimax(Evaluation evaluation, double minValue = -1, double maxValue = 1,
+                ChancePruning pruning = ChancePruning::Star2, std::size_t tableEntries = 1u << 18u);
+
+        /**
+         * Searches the best action of the first actor in the given turn order
+         * @param env the state to search, is not modified
+         * @param turnOrder ids of the acting players, one per ply. Plies after the last one start over at the
+         * first one. Banned and knocked out players skip their ply.
+         * @param limits depth and time limit. The first iteration is always completed.
+         * @throws std::invalid_argument if turnOrder is empty or contains no player
+         * @return the result of the deepest completed iteration
+         */
+        auto search(const std::shared_ptr<gameModel::Environment> &env,
+                const std::vector<communication::messages::types::EntityId> &turnOrder,
+                const SearchLimits &limits = {}) -> SearchResult;
+
+    private:
+        Evaluation evaluation;
+        double minValue;
+        double maxValue;
+        ChancePruning pruning;
+        TranspositionTable table;
+        std::pmr::monotonic_buffer_resource arena; ///< clones of the current search, declared before env to outlive it
+
+        std::shared_ptr<gameModel::Environment> env;
+        std::uint64_t hash = 0;
+        std::vector<communication::messages::types::EntityId> turnOrder;
+        std::vector<std::uint64_t> plyKeys;
+        gameModel::TeamSide rootSide = gameModel::TeamSide::LEFT;
+        std::chrono::steady_clock::time_point deadline;
+        bool mayAbort = false;
+        bool aborted = false;
+        std::uint64_t nodes = 0;
+
+        auto decision(unsigned int depth, unsigned int ply, double alpha, double beta,
+                std::size_t *bestIndex = nullptr) -> double;
+        auto chance(const Action &action, unsigned int depth, unsigned int ply, double alpha, double beta) -> double;
+        auto probe(unsigned int depth, unsigned int ply) -> double;
+        auto evaluate() const -> double;
+        auto getActor(unsigned int ply) const -> std::shared_ptr<gameModel::Player>;
+        bool isMaximizing(unsigned int ply) const;
+    };
+}
+
+#endif //SOPRAGAMELOGIC_EXPECTIMAX_H
@@ -13,17 +13,13 @@
 namespace gameController {
 
     double rng(double min, double max){
-        static std::random_device rd;
-        static std::default_random_engine el(rd());
         std::uniform_real_distribution dist(min, max);
-        return dist(el);
+        return dist(getRng());
     }
 
     int rng(int min, int max){
-        static std::random_device rd;
-        static std::default_random_engine el(rd());
         std::uniform_int_distribution dist(min, max);
-        return dist(el);
+        return dist(getRng());
     }
 
     bool actionTriggered(double actionProbability) {
@@ -34,11 +30,146 @@ namespace gameController {
         return rng(0.0, 1.0) < actionProbability;
     }
 
-    auto getAllCrossedCells(const gameModel::Position &startPoint, const gameModel::Position &endPoint) ->
-        std::vector<gameModel::Position> {
+    namespace {
+        /**
+         * Traverses the vector between two cells in steps of half a cell and collects all crossed cells
+         * which are not out of bounds. Only used to generate the crossed cells table.
+         * @param startPoint position of the first cell.
+         * @param endPoint position of the second cell.
+         * @param resultVect list where the crossed cells are appended
+         */
+        void traverseCrossedCells(const gameModel::Position &startPoint, const gameModel::Position &endPoint,
+                std::vector<gameModel::Position> &resultVect) {
+            // check if start and end point are equal
+            if (startPoint == endPoint)
+                return;
+
+            // define an normalize the direction vector
+            gameModel::Vector dirVect(endPoint.x - startPoint.x, endPoint.y - startPoint.y);
+            dirVect.normalize();
+
+            // traverse the route between the two points
+            gameModel::Vector travVect(0, 0);
+            gameModel::Position lastCell = startPoint;
+            while ((travVect + startPoint) != endPoint) {
+
+                // found a new crossed cell
+                if ((travVect + startPoint) != lastCell) {
+                    lastCell = travVect + startPoint;
+                    if(gameModel::Environment::getCell(lastCell) != gameModel::Cell::OutOfBounds){
+                        resultVect.emplace_back(lastCell);
+                    }
+                }
+
+                // make a step to travers the vector
+                travVect = travVect + (dirVect * 0.5);
+            }
+        }
+
+        /**
+         * Crossed cells for every pair of cells of the game field. Cells are stored as packed indices
+         * (x * FIELD_HEIGHT + y), the spans of all pairs are stored consecutively.
+         */
+        class CrossedCellsTable {
+        public:
+            static constexpr int CELLS = gameModel::FIELD_WIDTH * gameModel::FIELD_HEIGHT;
+
+            CrossedCellsTable() : offsets(static_cast<std::size_t>(CELLS * CELLS + 1), 0) {
+                std::vector<gameModel::Position> crossed;
+                crossed.reserve(gameModel::FIELD_WIDTH + gameModel::FIELD_HEIGHT);
+                for(int start = 0; start < CELLS; start++){
+                    for(int end = 0; end < CELLS; end++){
+                        auto startPos = unpack(start);
+                        auto endPos = unpack(end);
+                        if(gameModel::Environment::getCell(startPos) != gameModel::Cell::OutOfBounds &&
+                            gameModel::Environment::getCell(endPos) != gameModel::Cell::OutOfBounds){
+                            crossed.clear();
+                            traverseCrossedCells(startPos, endPos, crossed);
+                            for(const auto &cell : crossed){
+                                cells.emplace_back(static_cast<std::uint8_t>(cell.x * gameModel::FIELD_HEIGHT + cell.y));
+                            }
+                        }
+
+                        offsets[start * CELLS + end + 1] = static_cast<std::uint32_t>(cells.size());
+                    }
+                }
+
+                cells.shrink_to_fit();
+            }
 
-        std::vector<gameModel::Position> resultVect;
+            auto get(const gameModel::Position &startPoint, const gameModel::Position &endPoint) const -> CrossedCellsView {
+                auto index = static_cast<std::size_t>(pack(startPoint) * CELLS + pack(endPoint));
+                return {cells.data() + offsets[index], cells.data() + offsets[index + 1]};
+            }
+
+            static auto unpack(int cell) -> gameModel::Position {
+                return {cell / gameModel::FIELD_HEIGHT, cell % gameModel::FIELD_HEIGHT};
+            }
+
+        private:
+            std::vector<std::uint32_t> offsets;
+            std::vector<std::uint8_t> cells;
+
+            static int pack(const gameModel::Position &position) {
+                return position.x * gameModel::FIELD_HEIGHT + position.y;
+            }
+        };
 
+        auto crossedCellsTable() -> const CrossedCellsTable & {
+            static const CrossedCellsTable table;
+            return table;
+        }
+    }
+
+    CrossedCellsView::Iterator::Iterator(const std::uint8_t *cell) : cell(cell) {}
+
+    gameModel::Position CrossedCellsView::Iterator::operator*() const {
+        return CrossedCellsTable::unpack(*cell);
+    }
+
+    auto CrossedCellsView::Iterator::operator++() -> Iterator & {
+        cell++;
+        return *this;
+    }
+
+    auto CrossedCellsView::Iterator::operator++(int) -> Iterator {
+        Iterator ret = *this;
+        cell++;
+        return ret;
+    }
+
+    bool CrossedCellsView::Iterator::operator==(const Iterator &other) const {
+        return cell == other.cell;
+    }
+
+    bool CrossedCellsView::Iterator::operator!=(const Iterator &other) const {
+        return !(*this == other);
+    }
+
+    CrossedCellsView::CrossedCellsView(const std::uint8_t *first, const std::uint8_t *last) : first(first), last(last) {}
+
+    auto CrossedCellsView::begin() const -> Iterator {
+        return Iterator(first);
+    }
+
+    auto CrossedCellsView::end() const -> Iterator {
+        return Iterator(last);
+    }
+
+    auto CrossedCellsView::size() const -> std::size_t {
+        return static_cast<std::size_t>(last - first);
+    }
+
+    bool CrossedCellsView::empty() const {
+        return first == last;
+    }
+
+    gameModel::Position CrossedCellsView::operator[](std::size_t index) const {
+        return CrossedCellsTable::unpack(first[index]);
+    }
+
+    auto getCrossedCellsView(const gameModel::Position &startPoint, const gameModel::Position &endPoint) ->
+        CrossedCellsView {
         // check if cells are valid
         if (gameModel::Environment::getCell(startPoint) == gameModel::Cell::OutOfBounds ||
         gameModel::Environment::getCell(endPoint) == gameModel::Cell::OutOfBounds){
@@ -47,32 +178,13 @@ namespace gameController {
                                     "] end point was [" + std::to_string(endPoint.x) + ", " + std::to_string(endPoint.y) + "]");
         }
 
-        // check if start and end point are equal
-        if (startPoint == endPoint)
-            return resultVect;
-
-        // define an normalize the direction vector
-        gameModel::Vector dirVect(endPoint.x - startPoint.x, endPoint.y - startPoint.y);
-        dirVect.normalize();
-
-        // traverse the route between the two points
-        gameModel::Vector travVect(0, 0);
-        gameModel::Position lastCell = startPoint;
-        while ((travVect + startPoint) != endPoint) {
-
-            // found a new crossed cell
-            if ((travVect + startPoint) != lastCell) {
-                lastCell = travVect + startPoint;
-                if(gameModel::Environment::getCell(lastCell) != gameModel::Cell::OutOfBounds){
-                    resultVect.emplace_back(lastCell);
-                }
-            }
-
-            // make a step to travers the vector
-            travVect = travVect + (dirVect * 0.5);
-        }
+        return crossedCellsTable().get(startPoint, endPoint);
+    }
 
-        return resultVect;
+    auto getAllCrossedCells(const gameModel::Position &startPoint, const gameModel::Position &endPoint) ->
+        std::vector<gameModel::Position> {
+        auto crossedCells = getCrossedCellsView(startPoint, endPoint);
+        return {crossedCells.begin(), crossedCells.end()};
     }
 
     auto getDistance(const gameModel::Position &startPoint, const gameModel::Position &endPoint) -> int {
@@ -202,7 +314,7 @@ namespace gameController {
         }
 
         if(ball.has_value()){
-            if(INSTANCE_OF(ball.value(), gameModel::Quaffle)){
+            if(ball.value()->getId() == communication::messages::types::EntityId::QUAFFLE){
                 ret.reserve(69); //7 players * 9 cells + 6 goals
                 std::unordered_set<gameModel::Position> poses;
                 for(const auto &player : env->getTeamMates(actor)){
@@ -249,7 +361,7 @@ namespace gameController {
         std::vector<std::shared_ptr<gameModel::Player>> minDistancePlayers;
         for (const auto &player: players) {
 
-            if (!INSTANCE_OF(player, gameModel::Beater) && !player->isFined && bludger->position != player->position) {
+            if (player->getRole() != gameModel::PlayerRole::Beater && !player->isFined && bludger->position != player->position) {
                 auto dist = getDistance(bludger->position, player->position);
                 if (dist < minDistance) {
                     minDistance = dist;
@@ -267,7 +379,7 @@ namespace gameController {
             auto minDistancePlayer = minDistancePlayers[rng(0, static_cast<int>(minDistancePlayers.size() - 1))];
 
             // move towards nearest player
-            auto crossedCells = getAllCrossedCells(bludger->position, minDistancePlayer->position);
+            auto crossedCells = getCrossedCellsView(bludger->position, minDistancePlayer->position);
             if (crossedCells.empty()) {
                 // bludger will move on the players position
                 bludger->position = minDistancePlayer->position;
@@ -310,22 +422,21 @@ namespace gameController {
         }
 
         // check if there is generally allowed to perform a shot and a ball to shot on the same position as the player
-        if(player->position == env->quaffle->position && (INSTANCE_OF(player, const gameModel::Chaser) ||
-                                                          INSTANCE_OF(player, const gameModel::Keeper))){
+        if(player->position == env->quaffle->position && player->canHoldQuaffle()){
             return ActionType::Throw;
         }
         else if((player->position == env->bludgers[0]->position || player->position == env->bludgers[1]->position) &&
-                  INSTANCE_OF(player, const gameModel::Beater)){
+                  player->getRole() == gameModel::PlayerRole::Beater){
             return ActionType::Throw;
         }
 
         // check if player can wrest quaffel
         auto playerHoldingQuaffle = env->getPlayer(env->quaffle->position);
-        if(INSTANCE_OF(player, const gameModel::Chaser) && getDistance(player->position, env->quaffle->position) == 1 &&
+        if(player->getRole() == gameModel::PlayerRole::Chaser && getDistance(player->position, env->quaffle->position) == 1 &&
            playerHoldingQuaffle.has_value() && !playerHoldingQuaffle.value()->isFined &&
            !env->arePlayerInSameTeam(player, playerHoldingQuaffle.value()) &&
-           (INSTANCE_OF(playerHoldingQuaffle.value(), gameModel::Chaser) ||
-            (INSTANCE_OF(playerHoldingQuaffle.value(), gameModel::Keeper) &&
+           (playerHoldingQuaffle.value()->getRole() == gameModel::PlayerRole::Chaser ||
+            (playerHoldingQuaffle.value()->getRole() == gameModel::PlayerRole::Keeper &&
              !env->isPlayerInOwnRestrictedZone(playerHoldingQuaffle.value())))){
             return ActionType::Wrest;
         }
@@ -391,8 +502,7 @@ namespace gameController {
                     moveToAdjacent(env->snitch, env);
                     return false;
                 }
-                std::vector<gameModel::Position> newPosition = getAllCrossedCells(snitch->position,
-                                                                                  gameModel::Position(8, 6));
+                auto newPosition = getCrossedCellsView(snitch->position, gameModel::Position(8, 6));
                 if (newPosition.empty()) {
                     snitch->position = gameModel::Position{8,6};
                 }else{
@@ -401,7 +511,7 @@ namespace gameController {
 
                 auto playerOnSnitch = env->getPlayer(snitch->position);
                 if(playerOnSnitch.has_value() && !playerOnSnitch.value()->isFined){
-                    if(INSTANCE_OF(playerOnSnitch.value(), gameModel::Seeker)){
+                    if(playerOnSnitch.value()->getRole() == gameModel::PlayerRole::Seeker){
                         env->getTeam(playerOnSnitch.value())->score += 30;
                         return true;
                     } else{
@@ -10,9 +10,12 @@
 
 #include <memory>
 #include <vector>
+#include <cstdint>
+#include <iterator>
 
 #include "GameModel.h"
 #include "Action.h"
+#include "Rng.h"
 
 namespace gameController {
 
@@ -56,6 +59,81 @@ namespace gameController {
     auto getAllCrossedCells(const gameModel::Position &startPoint, const gameModel::Position &endPoint) ->
         std::vector<gameModel::Position>;
 
+    /**
+     * Non owning, read only view on the cells crossed by the vector between two cells.
+     * Views stay valid for the whole lifetime of the program.
+     */
+    class CrossedCellsView {
+    public:
+        /**
+         * Input iterator yielding the crossed cells as positions. The positions are decoded on dereference and
+         * returned by value, so the iterator does not meet the forward iterator requirements.
+         */
+        class Iterator {
+        public:
+            using iterator_category = std::input_iterator_tag;
+            using value_type = gameModel::Position;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = gameModel::Position;
+
+            Iterator() = default;
+            explicit Iterator(const std::uint8_t *cell);
+            gameModel::Position operator*() const;
+            Iterator &operator++();
+            Iterator operator++(int);
+            bool operator==(const Iterator &other) const;
+            bool operator!=(const Iterator &other) const;
+
+        private:
+            const std::uint8_t *cell = nullptr;
+        };
+
+        CrossedCellsView() = default;
+
+        /**
+         * main constructor for the view
+         * @param first first packed cell index of the view
+         * @param last one past the last packed cell index of the view
+         */
+        CrossedCellsView(const std::uint8_t *first, const std::uint8_t *last);
+
+        auto begin() const -> Iterator;
+        auto end() const -> Iterator;
+
+        /**
+         * @return number of crossed cells
+         */
+        auto size() const -> std::size_t;
+
+        /**
+         * @return true if no cell is crossed, false otherwise
+         */
+        bool empty() const;
+
+        /**
+         * Gets the i-th crossed cell in flight direction
+         * @param index index of the cell, must be smaller than size()
+         * @return the position of the crossed cell
+         */
+        gameModel::Position operator[](std::size_t index) const;
+
+    private:
+        const std::uint8_t *first = nullptr;
+        const std::uint8_t *last = nullptr;
+    };
+
+    /**
+     * Same as getAllCrossedCells but without allocating memory. The crossed cells of all pairs of valid cells
+     * are calculated once on first use.
+     * @param startPoint position of the first cell.
+     * @param endPoint position of the second cell.
+     * @throws std::out_of_range if startPoint or endPoint are out of bounds
+     * @return a view on all crossed cells in flight direction.
+     */
+    auto getCrossedCellsView(const gameModel::Position &startPoint, const gameModel::Position &endPoint) ->
+        CrossedCellsView;
+
     /**
      * get the distance between to cells on the game field.
      * @param startPoint position of the first cell.
@@ -108,7 +186,7 @@ namespace gameController {
     void moveQuaffelAfterGoal(const std::shared_ptr<gameModel::Environment> &env);
 
     /**
-     * generate a random number
+     * generate a random number drawn from the active engine of the calling thread (see getRng)
      * @param min lower boundary (inclusive)
      * @param max upper boundary (exclusive)
      * @return a random double number between min and max
@@ -116,7 +194,7 @@ namespace gameController {
     double rng(double min, double max);
 
     /**
-     * generate a random number
+     * generate a random number drawn from the active engine of the calling thread (see getRng)
      * @param min lower boundary (inclusive)
      * @param max upper boundary (inclusive)
      * @return a random integer number between min and max
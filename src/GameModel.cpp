@@ -11,14 +11,26 @@
 #include "SharedPtrSerialization.h"
 
 #include <utility>
+#include <algorithm>
 #include <iostream>
 #include <cmath>
+#include <type_traits>
 #include <utility>
 
 namespace gameModel{
 
-    Player::Player(Position position, communication::messages::types::Broom broom, communication::messages::types::EntityId id) :
-        Object(position, id), broom(broom), isFined{false} {
+    Player::Player(PlayerRole role) : role(role) {}
+
+    Player::Player(Position position, communication::messages::types::Broom broom, communication::messages::types::EntityId id,
+                   PlayerRole role) : Object(position, id), broom(broom), isFined{false}, role(role) {
+    }
+
+    PlayerRole Player::getRole() const {
+        return role;
+    }
+
+    bool Player::canHoldQuaffle() const {
+        return role == PlayerRole::Chaser || role == PlayerRole::Keeper;
     }
 
     bool Player::operator==(const Player &other) const {
@@ -33,24 +45,179 @@ namespace gameModel{
     }
 
 
-    // Fanblock
+    // Object index
+
+    namespace {
+        constexpr std::size_t PLAYERS_PER_TEAM = 7;
+        constexpr std::size_t NUMBER_OF_PLAYERS = 2 * PLAYERS_PER_TEAM;
+        constexpr std::size_t NUMBER_OF_OBJECTS = NUMBER_OF_PLAYERS + 4;
+
+        /**
+         * Maps players and balls to consecutive indices. Players first, per side in the order seeker, keeper,
+         * beaters, chasers, followed by quaffle, snitch and bludgers.
+         * @return the index or NUMBER_OF_OBJECTS if id is neither player nor ball
+         */
+        constexpr auto findObjectIndex(communication::messages::types::EntityId id) -> std::size_t {
+            using Id = communication::messages::types::EntityId;
+            switch (id) {
+                case Id::LEFT_SEEKER: return 0;
+                case Id::LEFT_KEEPER: return 1;
+                case Id::LEFT_BEATER1: return 2;
+                case Id::LEFT_BEATER2: return 3;
+                case Id::LEFT_CHASER1: return 4;
+                case Id::LEFT_CHASER2: return 5;
+                case Id::LEFT_CHASER3: return 6;
+                case Id::RIGHT_SEEKER: return 7;
+                case Id::RIGHT_KEEPER: return 8;
+                case Id::RIGHT_BEATER1: return 9;
+                case Id::RIGHT_BEATER2: return 10;
+                case Id::RIGHT_CHASER1: return 11;
+                case Id::RIGHT_CHASER2: return 12;
+                case Id::RIGHT_CHASER3: return 13;
+                case Id::QUAFFLE: return 14;
+                case Id::SNITCH: return 15;
+                case Id::BLUDGER1: return 16;
+                case Id::BLUDGER2: return 17;
+                default:
+                    return NUMBER_OF_OBJECTS;
+            }
+        }
+
+        /**
+         * Same as findObjectIndex
+         * @throws std::invalid_argument if id is neither player nor ball
+         */
+        auto objectIndex(communication::messages::types::EntityId id) -> std::size_t {
+            auto index = findObjectIndex(id);
+            if(index == NUMBER_OF_OBJECTS){
+                throw std::invalid_argument("Id is neither player nor ball");
+            }
+
+            return index;
+        }
+
+        /**
+         * Calls f with the member of the team holding the player with the given id. The member is found by the index
+         * of the id, members not carrying the id of their role are found by comparing all players.
+         * @return result of f or nothing if the player is not part of the team
+         */
+        template<typename F>
+        auto visitPlayer(const Team &team, communication::messages::types::EntityId id, F &&f) ->
+            std::optional<std::invoke_result_t<F &, const std::shared_ptr<Seeker> &>> {
+            auto matches = [id](const auto &player) {
+                return player->getId() == id;
+            };
+
+            const auto index = findObjectIndex(id);
+            if(index < NUMBER_OF_PLAYERS){
+                const auto slot = index % PLAYERS_PER_TEAM;
+                if(slot == 0 && matches(team.seeker)){
+                    return f(team.seeker);
+                } else if(slot == 1 && matches(team.keeper)){
+                    return f(team.keeper);
+                } else if(slot >= 2 && slot < 4 && matches(team.beaters[slot - 2])){
+                    return f(team.beaters[slot - 2]);
+                } else if(slot >= 4 && matches(team.chasers[slot - 4])){
+                    return f(team.chasers[slot - 4]);
+                }
+            }
+
+            if(matches(team.seeker)){
+                return f(team.seeker);
+            } else if(matches(team.keeper)){
+                return f(team.keeper);
+            }
+
+            for(const auto &beater : team.beaters){
+                if(matches(beater)){
+                    return f(beater);
+                }
+            }
+
+            for(const auto &chaser : team.chasers){
+                if(matches(chaser)){
+                    return f(chaser);
+                }
+            }
+
+            return std::nullopt;
+        }
+
+        /**
+         * Calls f with the player with the given id, starting the search at the team of the id's side
+         * @throws std::runtime_error if there is no such player
+         */
+        template<typename F>
+        auto visitPlayer(const Environment &env, communication::messages::types::EntityId id, F &&f) {
+            const auto index = findObjectIndex(id);
+            if(index < NUMBER_OF_PLAYERS){
+                const bool left = index < PLAYERS_PER_TEAM;
+                const auto &first = (env.team1->getSide() == TeamSide::LEFT) == left ? *env.team1 : *env.team2;
+                const auto &second = &first == env.team1.get() ? *env.team2 : *env.team1;
+                if(auto ret = visitPlayer(first, id, f)){
+                    return std::move(*ret);
+                } else if(auto other = visitPlayer(second, id, f)){
+                    return std::move(*other);
+                }
+            }
+
+            throw std::runtime_error("No player with specified in this match");
+        }
+
+        /**
+         * Calls f with the member of the Environment holding the ball with the given id
+         * @throws std::runtime_error if there is no such ball
+         */
+        template<typename F>
+        auto visitBall(const Environment &env, communication::messages::types::EntityId id, F &&f) {
+            using Id = communication::messages::types::EntityId;
+            switch (id) {
+                case Id::QUAFFLE:
+                    if(env.quaffle->getId() == id){
+                        return f(env.quaffle);
+                    }
+                    break;
+                case Id::SNITCH:
+                    if(env.snitch->getId() == id){
+                        return f(env.snitch);
+                    }
+                    break;
+                case Id::BLUDGER1:
+                case Id::BLUDGER2: {
+                    const auto &bludger = env.bludgers[id == Id::BLUDGER1 ? 0 : 1];
+                    if(bludger->getId() == id){
+                        return f(bludger);
+                    }
+                    break;
+                }
+                default:
+                    throw std::runtime_error("There is no matching Ball to the selected ID on the field!");
+            }
 
-    Fanblock::Fanblock(int teleportation, int rangedAttack, int impulse, int snitchPush, int blockCell) : currFans(), initialFans() {
-        using fan = InterferenceType ;
-        initialFans.emplace(fan::RangedAttack, rangedAttack);
-        initialFans.emplace(fan::Teleport, teleportation);
-        initialFans.emplace(fan::Impulse, impulse);
-        initialFans.emplace(fan::SnitchPush, snitchPush);
-        initialFans.emplace(fan::BlockCell, blockCell);
-        currFans.emplace(fan::RangedAttack, rangedAttack);
-        currFans.emplace(fan::Teleport, teleportation);
-        currFans.emplace(fan::Impulse, impulse);
-        currFans.emplace(fan::SnitchPush, snitchPush);
-        currFans.emplace(fan::BlockCell, blockCell);
+            for(const auto &bludger : env.bludgers){
+                if(bludger->getId() == id){
+                    return f(bludger);
+                }
+            }
+
+            if(env.quaffle->getId() == id){
+                return f(env.quaffle);
+            } else if(env.snitch->getId() == id){
+                return f(env.snitch);
+            }
+
+            throw std::runtime_error("There is no matching Ball to the selected ID on the field!");
+        }
     }
 
+
+    // Fanblock
+
+    Fanblock::Fanblock(int teleportation, int rangedAttack, int impulse, int snitchPush, int blockCell) :
+        currFans{rangedAttack, teleportation, impulse, snitchPush, blockCell}, initialFans(currFans) {}
+
     int Fanblock::getUses(InterferenceType fan) const {
-        return currFans.at(fan);
+        return currFans[static_cast<std::size_t>(fan)];
     }
 
     int Fanblock::getUses(communication::messages::types::FanType fan) const {
@@ -58,7 +225,8 @@ namespace gameModel{
     }
 
     int Fanblock::getBannedCount(gameModel::InterferenceType fan) const {
-        return initialFans.at(fan) - currFans.at(fan);
+        const auto index = static_cast<std::size_t>(fan);
+        return initialFans[index] - currFans[index];
     }
 
     int Fanblock::getBannedCount(communication::messages::types::FanType fan) const {
@@ -66,7 +234,7 @@ namespace gameModel{
     }
 
     void Fanblock::banFan(InterferenceType fan) {
-        if(--currFans.at(fan) < 0){
+        if(--currFans[static_cast<std::size_t>(fan)] < 0){
             throw std::runtime_error("No fans left to ban!");
         }
     }
@@ -76,30 +244,212 @@ namespace gameModel{
     }
 
 
+    // Clone resource
+
+    namespace {
+        thread_local std::pmr::memory_resource *activeCloneResource = nullptr;
+    }
+
+    auto getCloneResource() -> std::pmr::memory_resource * {
+        return activeCloneResource != nullptr ? activeCloneResource : std::pmr::get_default_resource();
+    }
+
+    ScopedCloneResource::ScopedCloneResource(std::pmr::memory_resource &resource) : previous(activeCloneResource) {
+        activeCloneResource = &resource;
+    }
+
+    ScopedCloneResource::~ScopedCloneResource() {
+        activeCloneResource = previous;
+    }
+
     // Environment
 
-    Cell Environment::getCell(int x, int y) {
-        if(x >= 17 || y >= 13 || x < 0 || y < 0) {
-            return Cell::OutOfBounds;
-        }else if((x == 2 || x == 14) && (y == 4 || y == 6 || y == 8)){
-            return x < 8 ? Cell::GoalLeft : Cell::GoalRight;
-        } else if(x > 6 && x < 10 && y > 4 && y < 8){
-            return Cell::Centre;
-        } else if(x > 4 && x < 12){
-            return Cell::Standard;
-        } else if((x == 4 || x == 12) && (y < 4 || y > 8)){
-            return Cell::Standard;
-        } else if((x == 3 || x == 13) && (y < 2 || y > 10)){
-            return Cell::Standard;
-        } else if(x > 1 && x < 15 && y > 0 && y < 12){
-            return x < 8 ? Cell::RestrictedLeft : Cell::RestrictedRight;
-        } else if(x > 0 && x < 16 && y > 1 && y < 11){
-            return x < 8 ? Cell::RestrictedLeft : Cell::RestrictedRight;
-        } else if(y > 3 && y < 9){
-            return x < 8 ? Cell::RestrictedLeft : Cell::RestrictedRight;
-        } else{
-            return Cell::OutOfBounds;
+    namespace {
+        /**
+         * Classifies the cell at position (x,y). Only used to generate the cell table at compile time
+         * @param x xPosition from left, 0 based
+         * @param y yPosition from bottom, 0 based
+         * @return The corresponding Cell
+         */
+        constexpr Cell classifyCell(int x, int y) {
+            if(x >= FIELD_WIDTH || y >= FIELD_HEIGHT || x < 0 || y < 0) {
+                return Cell::OutOfBounds;
+            }else if((x == 2 || x == 14) && (y == 4 || y == 6 || y == 8)){
+                return x < 8 ? Cell::GoalLeft : Cell::GoalRight;
+            } else if(x > 6 && x < 10 && y > 4 && y < 8){
+                return Cell::Centre;
+            } else if(x > 4 && x < 12){
+                return Cell::Standard;
+            } else if((x == 4 || x == 12) && (y < 4 || y > 8)){
+                return Cell::Standard;
+            } else if((x == 3 || x == 13) && (y < 2 || y > 10)){
+                return Cell::Standard;
+            } else if(x > 1 && x < 15 && y > 0 && y < 12){
+                return x < 8 ? Cell::RestrictedLeft : Cell::RestrictedRight;
+            } else if(x > 0 && x < 16 && y > 1 && y < 11){
+                return x < 8 ? Cell::RestrictedLeft : Cell::RestrictedRight;
+            } else if(y > 3 && y < 9){
+                return x < 8 ? Cell::RestrictedLeft : Cell::RestrictedRight;
+            } else{
+                return Cell::OutOfBounds;
+            }
+        }
+
+        /**
+         * Number of entries in the cell table. The last entry is an OutOfBounds sentinel for invalid coordinates
+         */
+        constexpr int CELL_TABLE_SIZE = FIELD_WIDTH * FIELD_HEIGHT + 1;
+
+        constexpr auto createCellTable() -> std::array<Cell, CELL_TABLE_SIZE> {
+            std::array<Cell, CELL_TABLE_SIZE> table{};
+            for(int x = 0; x < FIELD_WIDTH; x++){
+                for(int y = 0; y < FIELD_HEIGHT; y++){
+                    table[cellIndex(x, y)] = classifyCell(x, y);
+                }
+            }
+
+            table[CELL_TABLE_SIZE - 1] = Cell::OutOfBounds;
+            return table;
+        }
+
+        constexpr auto cellTable = createCellTable();
+
+        constexpr auto createValidCells() -> std::array<Position, 193> {
+            std::array<Position, 193> ret{};
+            std::size_t i = 0;
+            for(int x = 0; x < FIELD_WIDTH; x++){
+                for(int y = 0; y < FIELD_HEIGHT; y++){
+                    if(cellTable[cellIndex(x, y)] != Cell::OutOfBounds){
+                        ret[i].x = x;
+                        ret[i].y = y;
+                        i++;
+                    }
+                }
+            }
+
+            return ret;
         }
+
+        constexpr int countValidCells() {
+            int ret = 0;
+            for(const auto &cell : cellTable){
+                if(cell != Cell::OutOfBounds){
+                    ret++;
+                }
+            }
+
+            return ret;
+        }
+
+        static_assert(countValidCells() == 193, "Game field has to consist of 193 valid cells");
+
+        const auto validCells = createValidCells();
+
+        /**
+         * Creates a mask of all valid cells fulfilling the given predicate
+         * @tparam Predicate callable with signature bool(int x, int y, Cell cell)
+         * @param predicate
+         * @return
+         */
+        template <typename Predicate>
+        auto createCellMask(Predicate predicate) -> CellMask {
+            CellMask mask;
+            for(const auto &position : validCells){
+                if(predicate(position.x, position.y, cellTable[cellIndex(position.x, position.y)])){
+                    mask.set(cellIndex(position.x, position.y));
+                }
+            }
+
+            return mask;
+        }
+
+        /**
+         * Gets the mask of all cells a player of the given side may be redeployed to if they are free
+         * @param side
+         * @return
+         */
+        auto getRedeployMask(TeamSide side) -> const CellMask & {
+            static const CellMask left = createCellMask([](int x, int, Cell cell){
+                return x < FIELD_CENTRE_COL && cell != Cell::GoalLeft && cell != Cell::Centre;
+            });
+            static const CellMask right = createCellMask([](int x, int, Cell cell){
+                return x > FIELD_CENTRE_COL && cell != Cell::GoalRight && cell != Cell::Centre;
+            });
+            return side == TeamSide::LEFT ? left : right;
+        }
+
+        bool isInBounds(int x, int y) {
+            return x >= 0 && y >= 0 && x < FIELD_WIDTH && y < FIELD_HEIGHT;
+        }
+
+        /**
+         * Marks the cell of the given position in the mask, positions outside of the field are ignored
+         * @param mask
+         * @param position
+         */
+        void markCell(CellMask &mask, const Position &position) {
+            if(isInBounds(position.x, position.y)){
+                mask.set(cellIndex(position.x, position.y));
+            }
+        }
+
+        /**
+         * Appends all cells contained in the mask to the list, in the same order as Environment::getAllValidCells
+         * @param mask
+         * @param list
+         */
+        void appendCells(const CellMask &mask, std::vector<Position> &list) {
+            for(const auto &cell : validCells){
+                if(mask[cellIndex(cell.x, cell.y)]){
+                    list.emplace_back(cell);
+                }
+            }
+        }
+
+        /**
+         * Appends all cells in the square around position (excluding position) contained in the mask
+         * @param mask
+         * @param position centre of the square
+         * @param radius distance between position and the border of the square
+         * @param list
+         */
+        void appendCellsAround(const CellMask &mask, const Position &position, int radius, std::vector<Position> &list) {
+            for (int yPos = position.y - radius; yPos <= position.y + radius; yPos++) {
+                for (int xPos = position.x - radius; xPos <= position.x + radius; xPos++) {
+                    if ((xPos != position.x || yPos != position.y) && isInBounds(xPos, yPos) && mask[cellIndex(xPos, yPos)]) {
+                        list.emplace_back(xPos, yPos);
+                    }
+                }
+            }
+        }
+
+        /**
+         * Calls f on all players of the team in the order of Team::getAllPlayers until f returns true
+         * @tparam F callable accepting a shared_ptr to any player type and returning bool
+         * @param team
+         * @param f
+         * @return true if f returned true for any player
+         */
+        template <typename F>
+        bool anyPlayer(const Team &team, F f) {
+            return f(team.beaters[0]) || f(team.beaters[1]) || f(team.chasers[0]) || f(team.chasers[1]) ||
+                f(team.chasers[2]) || f(team.keeper) || f(team.seeker);
+        }
+    }
+
+    auto Occupancy::players() const -> CellMask {
+        return leftPlayers | rightPlayers;
+    }
+
+    auto Occupancy::free() const -> CellMask {
+        return Environment::getValidCellMask() & ~(leftPlayers | rightPlayers | balls);
+    }
+
+    Cell Environment::getCell(int x, int y) {
+        // unsigned comparison also rejects negative coordinates, invalid coordinates are mapped onto the sentinel
+        const bool inBounds = static_cast<unsigned int>(x) < static_cast<unsigned int>(FIELD_WIDTH) &&
+                static_cast<unsigned int>(y) < static_cast<unsigned int>(FIELD_HEIGHT);
+        return cellTable[inBounds ? cellIndex(x, y) : CELL_TABLE_SIZE - 1];
     }
 
     Cell Environment::getCell(const Position &position) {
@@ -159,37 +509,41 @@ namespace gameModel{
                 quaffle->position != position && bludgers[0]->position != position && bludgers[1]->position != position;
     }
 
-    auto Environment::getAllFreeCellsAround(const Position &position) const -> std::vector<Position> {
-        std::vector<Position> resultVect;
-        resultVect.reserve(8);
+    auto Environment::getOccupancy() const -> Occupancy {
+        Occupancy ret;
+        for(const auto &team : {team1.get(), team2.get()}){
+            auto &mask = team->getSide() == TeamSide::LEFT ? ret.leftPlayers : ret.rightPlayers;
+            anyPlayer(*team, [&mask](const auto &player){
+                if(!player->isFined){
+                    markCell(mask, player->position);
+                }
 
-        int startX = position.x - 1;
-        int endX = position.x + 1;
-        int startY = position.y - 1;
-        int endY = position.y + 1;
+                return false;
+            });
+        }
 
-        do {
-            for (int yPos = startY; yPos <= endY; yPos++) {
-                for (int xPos = startX; xPos <= endX; xPos++) {
-                    if (xPos == position.x && yPos == position.y) {
-                        continue;
-                    }
-                    else if (Environment::getCell(xPos, yPos) != Cell::OutOfBounds) {
-                        if (!cellIsFree({xPos, yPos})) {
-                            continue;
-                        }
-                        else {
-                            resultVect.emplace_back(Position(xPos, yPos));
-                        }
-                    }
-                }
-            }
+        markCell(ret.balls, quaffle->position);
+        markCell(ret.balls, bludgers[0]->position);
+        markCell(ret.balls, bludgers[1]->position);
+        if(snitch->exists){
+            markCell(ret.balls, snitch->position);
+        }
 
-            startX--;
-            endX++;
-            startY--;
-            endY++;
+        for(const auto &shit : pileOfShit){
+            markCell(ret.blocked, shit->position);
+        }
 
+        return ret;
+    }
+
+    auto Environment::getAllFreeCellsAround(const Position &position) const -> std::vector<Position> {
+        std::vector<Position> resultVect;
+        resultVect.reserve(8);
+        const auto freeCells = getOccupancy().free();
+        int radius = 1;
+        do {
+            appendCellsAround(freeCells, position, radius, resultVect);
+            radius++;
         } while (resultVect.empty());
 
         return resultVect;
@@ -214,13 +568,21 @@ namespace gameModel{
     }
 
     auto Environment::getPlayer(const Position &position) const -> std::optional<std::shared_ptr<Player>> {
-        for(const auto &p : getAllPlayers()){
-            if(!p->isFined && p->position == position){
-                return p;
+        std::optional<std::shared_ptr<Player>> ret;
+        auto findPlayer = [&ret, &position](const auto &player){
+            if(!player->isFined && player->position == position){
+                ret = player;
+                return true;
             }
+
+            return false;
+        };
+
+        if(!anyPlayer(*team1, findPlayer)){
+            anyPlayer(*team2, findPlayer);
         }
 
-        return {};
+        return ret;
     }
 
     auto Environment::arePlayerInSameTeam(const std::shared_ptr<const Player>& p1, const std::shared_ptr<const Player>& p2) const -> bool {
@@ -229,30 +591,20 @@ namespace gameModel{
     }
 
     auto Environment::getAllValidCells() -> std::array<Position, 193> {
-        std::array<Position, 193> ret{};
-        auto it = ret.begin();
-        for(int x = 0; x < 17; x++){
-            for(int y = 0; y < 13; y++){
-                if(getCell(x, y) != Cell::OutOfBounds){
-                    *it = {x, y};
-                    it++;
-                }
-            }
-        }
+        return validCells;
+    }
 
-        return ret;
+    auto Environment::getValidCellMask() -> const CellMask & {
+        static const CellMask mask = createCellMask([](int, int, Cell){
+            return true;
+        });
+        return mask;
     }
 
     auto Environment::getAllFreeCells() const -> std::vector<Position> {
-        //@TODO optimization!!!
         std::vector<Position> ret;
         ret.reserve(193);
-        for (const auto &cell : getAllValidCells()) {
-            if (cellIsFree(cell)) {
-                ret.emplace_back(cell);
-            }
-        }
-
+        appendCells(getOccupancy().free(), ret);
         return ret;
     }
 
@@ -306,60 +658,40 @@ namespace gameModel{
     }
 
     auto Environment::getPlayerById(communication::messages::types::EntityId id) const -> std::shared_ptr<Player> {
-        auto player = team1->getPlayerByID(id);
-        if(player.has_value()){
-            return player.value();
-        }
-
-        player = team2->getPlayerByID(id);
-        if(player.has_value()){
-            return player.value();
-        }
+        return visitPlayer(*this, id, [](const auto &player) -> std::shared_ptr<Player> {
+            return player;
+        });
+    }
 
-        throw std::runtime_error("No player with specified in this match");
+    auto Environment::getPlayerRef(communication::messages::types::EntityId id) const -> Player & {
+        return *visitPlayer(*this, id, [](const auto &player) -> Player * {
+            return player.get();
+        });
     }
 
     auto Environment::getBallByID(const communication::messages::types::EntityId &id) const -> std::shared_ptr<Ball> {
-        if (this->quaffle->getId() == id) {
-            return this->quaffle;
-        }
-        else if (this->snitch->getId() == id) {
-            return this->snitch;
-        }
-        else if (this->bludgers[0]->getId() == id) {
-            return this->bludgers[0];
-        }
-        else if (this->bludgers[1]->getId() == id) {
-            return this->bludgers[1];
-        }
-        else {
-            throw std::runtime_error("There is no matching Ball to the selected ID on the field!");
-        }
+        return visitBall(*this, id, [](const auto &ball) -> std::shared_ptr<Ball> {
+            return ball;
+        });
     }
 
-    auto Environment::isGoalCell(const Position &pos) -> bool {
-
-        for (const Position &goalPos : getGoalsLeft()) {
-            if (goalPos == pos) {
-                return true;
-            }
-        }
+    auto Environment::getBallRef(communication::messages::types::EntityId id) const -> Ball & {
+        return *visitBall(*this, id, [](const auto &ball) -> Ball * {
+            return ball.get();
+        });
+    }
 
-        for (const Position &goalPos : getGoalsRight()) {
-            if (goalPos == pos) {
-                return true;
-            }
-        }
-        return false;
+    auto Environment::isGoalCell(const Position &pos) -> bool {
+        const auto cell = getCell(pos);
+        return cell == Cell::GoalLeft || cell == Cell::GoalRight;
     }
 
     void Environment::removeDeprecatedShit() {
+        pileOfShit.erase(std::remove_if(pileOfShit.begin(), pileOfShit.end(), [](const std::shared_ptr<CubeOfShit> &shit) {
+            return !shit->spawnedThisRound;
+        }), pileOfShit.end());
         for (auto &shit : pileOfShit) {
-            if (shit->spawnedThisRound) {
-                shit->spawnedThisRound = false;
-            } else {
-                removeShitOnCell(shit->position);
-            }
+            shit->spawnedThisRound = false;
         }
     }
 
@@ -385,30 +717,117 @@ namespace gameModel{
     }
 
     auto Environment::clone() const -> std::shared_ptr<Environment> {
-        auto newQuaf = std::make_shared<Quaffle>(*this->quaffle);
-        auto newSnitch = std::make_shared<Snitch>(*this->snitch);
-        auto newBludgers = std::array<std::shared_ptr<Bludger>, 2>{std::make_shared<Bludger>(*this->bludgers[0]),
-                std::make_shared<Bludger>(*this->bludgers[1])};
+        return clone(getCloneResource());
+    }
+
+    auto Environment::clone(std::pmr::memory_resource *resource) const -> std::shared_ptr<Environment> {
+        std::pmr::polymorphic_allocator<std::byte> alloc(resource);
+        auto newQuaf = std::allocate_shared<Quaffle>(alloc, *this->quaffle);
+        auto newSnitch = std::allocate_shared<Snitch>(alloc, *this->snitch);
+        auto newBludgers = std::array<std::shared_ptr<Bludger>, 2>{std::allocate_shared<Bludger>(alloc, *this->bludgers[0]),
+                std::allocate_shared<Bludger>(alloc, *this->bludgers[1])};
         std::deque<std::shared_ptr<CubeOfShit>> newShit;
         for(const auto &shit : pileOfShit){
-            newShit.emplace_back(std::make_shared<CubeOfShit>(*shit));
+            newShit.emplace_back(std::allocate_shared<CubeOfShit>(alloc, *shit));
         }
 
-        return std::make_shared<Environment>(this->config, this->team1->clone(), this->team2->clone(),
-                newQuaf, newSnitch, newBludgers, newShit);
+        return std::allocate_shared<Environment>(alloc, this->config, this->team1->clone(resource),
+                this->team2->clone(resource), std::move(newQuaf), std::move(newSnitch), std::move(newBludgers),
+                std::move(newShit));
+    }
+
+    namespace {
+        /**
+         * Replaces an object by a copy if it is referenced from anywhere else
+         * @param object reference to the owning pointer
+         * @param resource resource the copy is allocated from
+         */
+        template<typename T>
+        void copyIfShared(std::shared_ptr<T> &object, std::pmr::memory_resource *resource) {
+            if(object.use_count() > 1){
+                object = std::allocate_shared<T>(std::pmr::polymorphic_allocator<std::byte>(resource), *object);
+            }
+        }
+    }
+
+    auto Environment::fork(const std::function<void(Environment &)> &modify) const ->
+        std::shared_ptr<const Environment> {
+        auto ret = std::allocate_shared<Environment>(std::pmr::polymorphic_allocator<std::byte>(getCloneResource()),
+                *this);
+        modify(*ret);
+        return ret;
+    }
+
+    auto Environment::mutableTeam(TeamSide side) -> std::shared_ptr<Team> {
+        auto &team = team1->getSide() == side ? team1 : team2;
+        copyIfShared(team, getCloneResource());
+        return team;
+    }
+
+    auto Environment::mutablePlayer(communication::messages::types::EntityId id) -> std::shared_ptr<Player> {
+        if(!gameLogic::conversions::isPlayer(id)){
+            throw std::runtime_error("No player with specified in this match");
+        }
+
+        auto team = mutableTeam(gameLogic::conversions::idToSide(id));
+        auto resource = getCloneResource();
+        if(team->seeker->getId() == id){
+            copyIfShared(team->seeker, resource);
+            return team->seeker;
+        } else if(team->keeper->getId() == id){
+            copyIfShared(team->keeper, resource);
+            return team->keeper;
+        }
+
+        for(auto &beater : team->beaters){
+            if(beater->getId() == id){
+                copyIfShared(beater, resource);
+                return beater;
+            }
+        }
+
+        for(auto &chaser : team->chasers){
+            if(chaser->getId() == id){
+                copyIfShared(chaser, resource);
+                return chaser;
+            }
+        }
+
+        throw std::runtime_error("No player with specified in this match");
+    }
+
+    auto Environment::mutableBall(communication::messages::types::EntityId id) -> std::shared_ptr<Ball> {
+        auto resource = getCloneResource();
+        switch (id){
+            case communication::messages::types::EntityId::QUAFFLE:
+                copyIfShared(quaffle, resource);
+                return quaffle;
+            case communication::messages::types::EntityId::SNITCH:
+                copyIfShared(snitch, resource);
+                return snitch;
+            case communication::messages::types::EntityId::BLUDGER1:
+                copyIfShared(bludgers[0], resource);
+                return bludgers[0];
+            case communication::messages::types::EntityId::BLUDGER2:
+                copyIfShared(bludgers[1], resource);
+                return bludgers[1];
+            default:
+                throw std::runtime_error("There is no matching Ball to the selected ID on the field!");
+        }
     }
 
     auto Environment::getAllLegalCellsAround(const Position &position, bool leftTeam) const -> std::vector<Position> {
         std::vector<Position> ret;
         ret.reserve(8);
+        const auto occupancy = getOccupancy();
+        const auto &opponents = leftTeam ? occupancy.rightPlayers : occupancy.leftPlayers;
         for(int x = position.x - 1; x <= position.x + 1; x++){
             for(int y = position.y - 1; y <= position.y + 1; y++){
                 Position curr(x, y);
-                auto playerOnCell = getPlayer(curr);
-                auto opponentTeam = leftTeam ? getTeam(TeamSide::RIGHT) : getTeam(TeamSide::LEFT);
-                bool ownGoalCell = leftTeam ? getCell(curr) == Cell::GoalLeft : getCell(curr) == Cell::GoalRight;
-                if(curr != position && getCell(curr) != Cell::OutOfBounds && !isShitOnCell(curr) && !ownGoalCell &&
-                    (!playerOnCell.has_value() || !opponentTeam->hasMember(playerOnCell.value()))){
+                const auto cell = getCell(curr);
+                bool ownGoalCell = leftTeam ? cell == Cell::GoalLeft : cell == Cell::GoalRight;
+                if(curr != position && cell != Cell::OutOfBounds && !ownGoalCell &&
+                    !occupancy.blocked[cellIndex(x, y)] && !opponents[cellIndex(x, y)]){
                     ret.emplace_back(curr);
                 }
             }
@@ -420,12 +839,12 @@ namespace gameModel{
     auto Environment::getAllEmptyCellsAround(const Position &position) const -> std::vector<Position> {
         std::vector<Position> ret;
         ret.reserve(8);
+        const auto occupancy = getOccupancy();
+        const auto emptyCells = occupancy.free() & ~occupancy.blocked;
         for(int x = position.x - 1; x <= position.x + 1; x++){
             for(int y = position.y - 1; y <= position.y + 1; y++){
-                Position curr(x, y);
-                if(curr != position && getCell(curr) != Cell::OutOfBounds &&
-                    cellIsFree(curr) && !isShitOnCell(curr)){
-                    ret.emplace_back(curr);
+                if((x != position.x || y != position.y) && isInBounds(x, y) && emptyCells[cellIndex(x, y)]){
+                    ret.emplace_back(x, y);
                 }
             }
         }
@@ -436,19 +855,8 @@ namespace gameModel{
     auto Environment::getFreeCellsForRedeploy(const gameModel::TeamSide &teamSide)const -> const std::vector<gameModel::Position> {
         std::vector<gameModel::Position> ret;
         ret.reserve(84);
-        for(const auto &cell : this->getAllFreeCells()){
-            if(teamSide == gameModel::TeamSide::LEFT){
-                if(cell.x < FIELD_CENTRE_COL && this->getCell(cell) != gameModel::Cell::GoalLeft &&
-                    this->cellIsFree(cell) && !this->isShitOnCell(cell) && this->getCell(cell) != gameModel::Cell::Centre){
-                    ret.emplace_back(cell);
-                }
-            }else{
-                if(cell.x > FIELD_CENTRE_COL && this->getCell(cell) != gameModel::Cell::GoalRight &&
-                    this->cellIsFree(cell) && !this->isShitOnCell(cell) && this->getCell(cell) != gameModel::Cell::Centre){
-                    ret.emplace_back(cell);
-                }
-            }
-        }
+        const auto occupancy = getOccupancy();
+        appendCells(occupancy.free() & ~occupancy.blocked & getRedeployMask(teamSide), ret);
         return ret;
     }
 
@@ -473,6 +881,365 @@ namespace gameModel{
         return !(*this == other);
     }
 
+    // Zobrist
+
+    namespace {
+        constexpr std::size_t NUMBER_OF_CELLS = FIELD_WIDTH * FIELD_HEIGHT;
+
+        constexpr auto splitMix64(std::uint64_t x) -> std::uint64_t {
+            x += 0x9E3779B97F4A7C15ull;
+            x = (x ^ (x >> 30u)) * 0xBF58476D1CE4E5B9ull;
+            x = (x ^ (x >> 27u)) * 0x94D049BB133111EBull;
+            return x ^ (x >> 31u);
+        }
+
+        template<std::size_t N>
+        constexpr auto createZobristTable(std::uint64_t seed) -> std::array<std::uint64_t, N> {
+            std::array<std::uint64_t, N> ret{};
+            for(std::size_t i = 0; i < N; i++){
+                ret[i] = splitMix64(seed + i);
+            }
+
+            return ret;
+        }
+
+        constexpr auto positionKeys = createZobristTable<NUMBER_OF_OBJECTS * NUMBER_OF_CELLS>(0x1000000);
+        constexpr auto cubeKeys = createZobristTable<2 * NUMBER_OF_CELLS>(0x2000000);
+        constexpr auto flagKeys = createZobristTable<2 * NUMBER_OF_PLAYERS + 1>(0x3000000);
+        constexpr std::uint64_t SCORE_SEED = 0x4000000;
+        constexpr std::uint64_t FAN_SEED = 0x5000000;
+
+        auto playerIndex(communication::messages::types::EntityId id) -> std::size_t {
+            auto index = objectIndex(id);
+            if(index >= NUMBER_OF_PLAYERS){
+                throw std::invalid_argument("Id is no player");
+            }
+
+            return index;
+        }
+
+        /**
+         * Index of a cell in the key tables. Positions out of bounds share one index per object since they only occur
+         * as temporary states.
+         */
+        auto cellKeyIndex(const Position &position) -> std::size_t {
+            if(Environment::getCell(position) == Cell::OutOfBounds){
+                return 0;
+            }
+
+            return cellIndex(position.x, position.y);
+        }
+
+        auto playerKeys(const Player &player) -> std::uint64_t {
+            auto ret = zobrist::position(player.getId(), player.position);
+            if(player.knockedOut){
+                ret ^= zobrist::knockedOut(player.getId());
+            }
+
+            if(player.isFined){
+                ret ^= zobrist::fined(player.getId());
+            }
+
+            return ret;
+        }
+
+        auto teamKeys(const Team &team) -> std::uint64_t {
+            std::uint64_t ret = zobrist::score(team.getSide(), team.score);
+            anyPlayer(team, [&ret](const auto &player){
+                ret ^= playerKeys(*player);
+                return false;
+            });
+
+            for(auto type : {InterferenceType::RangedAttack, InterferenceType::Teleport, InterferenceType::Impulse,
+                             InterferenceType::SnitchPush, InterferenceType::BlockCell}){
+                ret ^= zobrist::fans(team.getSide(), type, team.fanblock.getUses(type));
+            }
+
+            return ret;
+        }
+    }
+
+    auto zobrist::position(communication::messages::types::EntityId id, const Position &position) -> std::uint64_t {
+        return positionKeys[objectIndex(id) * NUMBER_OF_CELLS + cellKeyIndex(position)];
+    }
+
+    auto zobrist::knockedOut(communication::messages::types::EntityId id) -> std::uint64_t {
+        return flagKeys[playerIndex(id)];
+    }
+
+    auto zobrist::fined(communication::messages::types::EntityId id) -> std::uint64_t {
+        return flagKeys[NUMBER_OF_PLAYERS + playerIndex(id)];
+    }
+
+    auto zobrist::snitchExists() -> std::uint64_t {
+        return flagKeys[2 * NUMBER_OF_PLAYERS];
+    }
+
+    auto zobrist::cube(const Position &position, bool spawnedThisRound, std::size_t count) -> std::uint64_t {
+        if(count == 0){
+            return 0;
+        }
+
+        auto key = cubeKeys[(spawnedThisRound ? NUMBER_OF_CELLS : 0) + cellKeyIndex(position)];
+        return count == 1 ? key : splitMix64(key ^ static_cast<std::uint64_t>(count));
+    }
+
+    auto zobrist::score(TeamSide side, int score) -> std::uint64_t {
+        auto sideBit = static_cast<std::uint64_t>(side == TeamSide::LEFT ? 0 : 1);
+        return splitMix64(SCORE_SEED ^ (static_cast<std::uint64_t>(static_cast<std::uint32_t>(score)) << 1u) ^ sideBit);
+    }
+
+    auto zobrist::fans(TeamSide side, InterferenceType type, int uses) -> std::uint64_t {
+        auto sideBit = static_cast<std::uint64_t>(side == TeamSide::LEFT ? 0 : 1);
+        auto typeBits = static_cast<std::uint64_t>(type) << 1u;
+        return splitMix64(FAN_SEED ^ (static_cast<std::uint64_t>(static_cast<std::uint32_t>(uses)) << 8u) ^ typeBits ^ sideBit);
+    }
+
+    auto Environment::getHash() const -> std::uint64_t {
+        auto ret = teamKeys(*team1) ^ teamKeys(*team2);
+        ret ^= zobrist::position(quaffle->getId(), quaffle->position);
+        ret ^= zobrist::position(snitch->getId(), snitch->position);
+        for(const auto &bludger : bludgers){
+            ret ^= zobrist::position(bludger->getId(), bludger->position);
+        }
+
+        if(snitch->exists){
+            ret ^= zobrist::snitchExists();
+        }
+
+        for(auto it = pileOfShit.begin(); it != pileOfShit.end(); it++){
+            const auto &cube = **it;
+            auto isStacked = [&cube](const std::shared_ptr<CubeOfShit> &other){
+                return other->position == cube.position && other->spawnedThisRound == cube.spawnedThisRound;
+            };
+
+            if(std::none_of(pileOfShit.begin(), it, isStacked)){
+                auto count = static_cast<std::size_t>(std::count_if(it, pileOfShit.end(), isStacked));
+                ret ^= zobrist::cube(cube.position, cube.spawnedThisRound, count);
+            }
+        }
+
+        return ret;
+    }
+
+    // CompactEnvironment
+
+    static_assert(std::is_trivially_copyable_v<CompactEnvironment>, "CompactEnvironment has to be copyable via memcpy");
+    static_assert(sizeof(CompactEnvironment) <= 256, "CompactEnvironment should fit into four cache lines");
+
+    namespace {
+        using PlayerState = CompactEnvironment::PlayerState;
+        using TeamState = CompactEnvironment::TeamState;
+        using CellPosition = CompactEnvironment::CellPosition;
+
+        constexpr std::array<InterferenceType, CompactEnvironment::NUMBER_OF_FANS> fanTypes =
+                {InterferenceType::RangedAttack, InterferenceType::Teleport, InterferenceType::Impulse,
+                 InterferenceType::SnitchPush, InterferenceType::BlockCell};
+
+        auto toCellPosition(const Position &position) -> CellPosition {
+            return {static_cast<std::int8_t>(position.x), static_cast<std::int8_t>(position.y)};
+        }
+
+        auto toPosition(const CellPosition &position) -> Position {
+            return {position.x, position.y};
+        }
+
+        /**
+         * Gets the players of a team in the order used by TeamState
+         */
+        auto getTeamPlayers(const Team &team) -> std::array<std::shared_ptr<Player>, 7> {
+            return {team.seeker, team.keeper, team.beaters[0], team.beaters[1],
+                    team.chasers[0], team.chasers[1], team.chasers[2]};
+        }
+
+        auto capturePlayer(const Player &player) -> PlayerState {
+            return {toCellPosition(player.position), static_cast<std::uint8_t>(player.getId()),
+                    static_cast<std::uint8_t>(player.broom), player.isFined, player.knockedOut};
+        }
+
+        void restorePlayer(const PlayerState &state, Player &player) {
+            player.position = toPosition(state.position);
+            player.broom = static_cast<communication::messages::types::Broom>(state.broom);
+            player.isFined = state.isFined;
+            player.knockedOut = state.knockedOut;
+        }
+
+        template<typename T>
+        auto createPlayer(const PlayerState &state) -> T {
+            T player{toPosition(state.position), static_cast<communication::messages::types::Broom>(state.broom),
+                     static_cast<communication::messages::types::EntityId>(state.id)};
+            restorePlayer(state, player);
+            return player;
+        }
+
+        auto captureTeam(const Team &team) -> TeamState {
+            TeamState ret;
+            auto players = getTeamPlayers(team);
+            for(std::size_t i = 0; i < players.size(); i++){
+                ret.players[i] = capturePlayer(*players[i]);
+            }
+
+            ret.score = team.score;
+            for(std::size_t i = 0; i < fanTypes.size(); i++){
+                auto uses = team.fanblock.getUses(fanTypes[i]);
+                ret.currFans[i] = static_cast<std::uint8_t>(uses);
+                ret.initialFans[i] = static_cast<std::uint8_t>(uses + team.fanblock.getBannedCount(fanTypes[i]));
+            }
+
+            ret.side = team.getSide();
+            return ret;
+        }
+
+        auto createFanblock(const TeamState &state) -> Fanblock {
+            const auto &fans = state.initialFans;
+            return {fans[1], fans[0], fans[2], fans[3], fans[4]};
+        }
+    }
+
+    CompactEnvironment::CompactEnvironment(const Environment &env) : team1(captureTeam(*env.team1)),
+        team2(captureTeam(*env.team2)), quaffle(toCellPosition(env.quaffle->position)),
+        snitch(toCellPosition(env.snitch->position)), bludgers{toCellPosition(env.bludgers[0]->position),
+        toCellPosition(env.bludgers[1]->position)}, snitchExists(env.snitch->exists) {
+        if(env.pileOfShit.size() > MAX_CUBES){
+            throw std::invalid_argument("Too many cubes of shit for CompactEnvironment");
+        }
+
+        numberOfCubes = static_cast<std::uint8_t>(env.pileOfShit.size());
+        for(std::size_t i = 0; i < env.pileOfShit.size(); i++){
+            pileOfShit[i] = {toCellPosition(env.pileOfShit[i]->position), env.pileOfShit[i]->spawnedThisRound};
+        }
+    }
+
+    auto CompactEnvironment::toEnvironment(const Config &config) const -> std::shared_ptr<Environment> {
+        auto createTeam = [](const TeamState &state){
+            const auto &p = state.players;
+            auto fanblock = createFanblock(state);
+            for(std::size_t i = 0; i < fanTypes.size(); i++){
+                fanblock.currFans[static_cast<std::size_t>(fanTypes[i])] = state.currFans[i];
+            }
+
+            return std::make_shared<Team>(createPlayer<Seeker>(p[0]), createPlayer<Keeper>(p[1]),
+                    std::array<Beater, 2>{createPlayer<Beater>(p[2]), createPlayer<Beater>(p[3])},
+                    std::array<Chaser, 3>{createPlayer<Chaser>(p[4]), createPlayer<Chaser>(p[5]), createPlayer<Chaser>(p[6])},
+                    state.score, std::move(fanblock), state.side);
+        };
+
+        auto newSnitch = std::make_shared<Snitch>(toPosition(snitch));
+        newSnitch->exists = snitchExists;
+        std::deque<std::shared_ptr<CubeOfShit>> newShit;
+        for(std::size_t i = 0; i < numberOfCubes; i++){
+            auto cube = std::make_shared<CubeOfShit>(toPosition(pileOfShit[i].position));
+            cube->spawnedThisRound = pileOfShit[i].spawnedThisRound;
+            newShit.emplace_back(std::move(cube));
+        }
+
+        return std::make_shared<Environment>(config, createTeam(team1), createTeam(team2),
+                std::make_shared<Quaffle>(toPosition(quaffle)), std::move(newSnitch),
+                std::array<std::shared_ptr<Bludger>, 2>{
+                    std::make_shared<Bludger>(toPosition(bludgers[0]), communication::messages::types::EntityId::BLUDGER1),
+                    std::make_shared<Bludger>(toPosition(bludgers[1]), communication::messages::types::EntityId::BLUDGER2)},
+                std::move(newShit));
+    }
+
+    void CompactEnvironment::applyTo(Environment &env) const {
+        if(env.team1->getSide() != team1.side || env.team2->getSide() != team2.side){
+            throw std::invalid_argument("Team sides of the Environment do not match");
+        }
+
+        auto restoreTeam = [](const TeamState &state, Team &team){
+            auto players = getTeamPlayers(team);
+            for(std::size_t i = 0; i < players.size(); i++){
+                restorePlayer(state.players[i], *players[i]);
+            }
+
+            team.score = state.score;
+            for(std::size_t i = 0; i < fanTypes.size(); i++){
+                if(team.fanblock.initialFans[static_cast<std::size_t>(fanTypes[i])] != state.initialFans[i]){
+                    team.fanblock = createFanblock(state);
+                    break;
+                }
+            }
+
+            for(std::size_t i = 0; i < fanTypes.size(); i++){
+                team.fanblock.currFans[static_cast<std::size_t>(fanTypes[i])] = state.currFans[i];
+            }
+        };
+
+        restoreTeam(team1, *env.team1);
+        restoreTeam(team2, *env.team2);
+        env.quaffle->position = toPosition(quaffle);
+        env.snitch->position = toPosition(snitch);
+        env.snitch->exists = snitchExists;
+        env.bludgers[0]->position = toPosition(bludgers[0]);
+        env.bludgers[1]->position = toPosition(bludgers[1]);
+
+        while(env.pileOfShit.size() > numberOfCubes){
+            env.pileOfShit.pop_back();
+        }
+
+        for(std::size_t i = 0; i < numberOfCubes; i++){
+            if(i == env.pileOfShit.size()){
+                env.pileOfShit.emplace_back(std::make_shared<CubeOfShit>(toPosition(pileOfShit[i].position)));
+            }
+
+            env.pileOfShit[i]->position = toPosition(pileOfShit[i].position);
+            env.pileOfShit[i]->spawnedThisRound = pileOfShit[i].spawnedThisRound;
+        }
+    }
+
+    bool CompactEnvironment::operator==(const CompactEnvironment &other) const {
+        if(numberOfCubes != other.numberOfCubes){
+            return false;
+        }
+
+        for(std::size_t i = 0; i < numberOfCubes; i++){
+            if(pileOfShit[i] != other.pileOfShit[i]){
+                return false;
+            }
+        }
+
+        return team1 == other.team1 && team2 == other.team2 && quaffle == other.quaffle && snitch == other.snitch &&
+            bludgers == other.bludgers && snitchExists == other.snitchExists;
+    }
+
+    bool CompactEnvironment::operator!=(const CompactEnvironment &other) const {
+        return !(*this == other);
+    }
+
+    bool CompactEnvironment::CellPosition::operator==(const CellPosition &other) const {
+        return x == other.x && y == other.y;
+    }
+
+    bool CompactEnvironment::CellPosition::operator!=(const CellPosition &other) const {
+        return !(*this == other);
+    }
+
+    bool CompactEnvironment::PlayerState::operator==(const PlayerState &other) const {
+        return position == other.position && id == other.id && broom == other.broom &&
+            isFined == other.isFined && knockedOut == other.knockedOut;
+    }
+
+    bool CompactEnvironment::PlayerState::operator!=(const PlayerState &other) const {
+        return !(*this == other);
+    }
+
+    bool CompactEnvironment::TeamState::operator==(const TeamState &other) const {
+        return players == other.players && score == other.score && currFans == other.currFans &&
+            initialFans == other.initialFans && side == other.side;
+    }
+
+    bool CompactEnvironment::TeamState::operator!=(const TeamState &other) const {
+        return !(*this == other);
+    }
+
+    bool CompactEnvironment::CubeState::operator==(const CubeState &other) const {
+        return position == other.position && spawnedThisRound == other.spawnedThisRound;
+    }
+
+    bool CompactEnvironment::CubeState::operator!=(const CubeState &other) const {
+        return !(*this == other);
+    }
+
 
     // Ball Types
 
@@ -504,25 +1271,38 @@ namespace gameModel{
 
     Quaffle::Quaffle() : Ball({8, 6}, communication::messages::types::EntityId::QUAFFLE){}
 
+    Chaser::Chaser() : Player(PlayerRole::Chaser) {}
+
     Chaser::Chaser(Position position, communication::messages::types::Broom broom, communication::messages::types::EntityId id) :
-            Player(position, broom, id) {}
+            Player(position, broom, id, PlayerRole::Chaser) {}
+
+    Keeper::Keeper() : Player(PlayerRole::Keeper) {}
 
     Keeper::Keeper(Position position, communication::messages::types::Broom broom, communication::messages::types::EntityId id) :
-            Player(position, broom, id) {}
+            Player(position, broom, id, PlayerRole::Keeper) {}
+
+    Seeker::Seeker() : Player(PlayerRole::Seeker) {}
 
     Seeker::Seeker(Position position, communication::messages::types::Broom broom, communication::messages::types::EntityId id) :
-            Player(position, broom, id) {}
+            Player(position, broom, id, PlayerRole::Seeker) {}
+
+    Beater::Beater() : Player(PlayerRole::Beater) {}
 
     Beater::Beater(Position position, communication::messages::types::Broom broom, communication::messages::types::EntityId id) :
-            Player(position, broom, id) {}
+            Player(position, broom, id, PlayerRole::Beater) {}
 
 
     // Team
 
     Team::Team(Seeker seeker, Keeper keeper, std::array<Beater, 2> beaters, std::array<Chaser, 3> chasers, int score, Fanblock fanblock, TeamSide side) :
-               seeker(std::make_shared<Seeker>(std::move(seeker))), keeper(std::make_shared<Keeper>(std::move(keeper))), beaters{std::make_shared<Beater>(std::move(beaters[0])),
-                       std::make_shared<Beater>(std::move(beaters[1]))}, chasers{std::make_shared<Chaser>(std::move(chasers[0])), std::make_shared<Chaser>(std::move(chasers[1])),
-                               std::make_shared<Chaser>(std::move(chasers[2]))}, score(score), fanblock(std::move(fanblock)), side(side) {
+               Team(std::make_shared<Seeker>(std::move(seeker)), std::make_shared<Keeper>(std::move(keeper)), {std::make_shared<Beater>(std::move(beaters[0])),
+                       std::make_shared<Beater>(std::move(beaters[1]))}, {std::make_shared<Chaser>(std::move(chasers[0])), std::make_shared<Chaser>(std::move(chasers[1])),
+                               std::make_shared<Chaser>(std::move(chasers[2]))}, score, std::move(fanblock), side) {}
+
+    Team::Team(std::shared_ptr<Seeker> seeker, std::shared_ptr<Keeper> keeper, std::array<std::shared_ptr<Beater>, 2> beaters,
+               std::array<std::shared_ptr<Chaser>, 3> chasers, int score, Fanblock fanblock, TeamSide side) :
+               seeker(std::move(seeker)), keeper(std::move(keeper)), beaters(std::move(beaters)), chasers(std::move(chasers)),
+               score(score), fanblock(std::move(fanblock)), side(side) {
         for(const auto &player : getAllPlayers()){
             if(gameLogic::conversions::idToSide(player->getId()) != this->side){
                 throw std::invalid_argument("Player-IDs not matching team side");
@@ -582,18 +1362,25 @@ namespace gameModel{
     }
 
     auto Team::getPlayerByID(communication::messages::types::EntityId id) const -> std::optional<std::shared_ptr<Player>> {
-        for(const auto &player : getAllPlayers()){
-            if(player->getId() == id){
-                return player;
-            }
-        }
-
-        return {};
+        return visitPlayer(*this, id, [](const auto &player) -> std::shared_ptr<Player> {
+            return player;
+        });
     }
 
     auto Team::clone() const -> std::shared_ptr<Team> {
-        return std::make_shared<Team>(*this->seeker, *this->keeper, std::array<Beater, 2>{*this->beaters[0], *this->beaters[1]},
-                std::array<Chaser, 3>{*this->chasers[0], *this->chasers[1], *this->chasers[2]}, this->score, this->fanblock, this->side);
+        return clone(getCloneResource());
+    }
+
+    auto Team::clone(std::pmr::memory_resource *resource) const -> std::shared_ptr<Team> {
+        std::pmr::polymorphic_allocator<std::byte> alloc(resource);
+        return std::allocate_shared<Team>(alloc, std::allocate_shared<Seeker>(alloc, *this->seeker),
+                std::allocate_shared<Keeper>(alloc, *this->keeper),
+                std::array<std::shared_ptr<Beater>, 2>{std::allocate_shared<Beater>(alloc, *this->beaters[0]),
+                                                       std::allocate_shared<Beater>(alloc, *this->beaters[1])},
+                std::array<std::shared_ptr<Chaser>, 3>{std::allocate_shared<Chaser>(alloc, *this->chasers[0]),
+                                                       std::allocate_shared<Chaser>(alloc, *this->chasers[1]),
+                                                       std::allocate_shared<Chaser>(alloc, *this->chasers[2])},
+                this->score, this->fanblock, this->side);
     }
 
     TeamSide Team::getSide() const {
@@ -602,13 +1389,88 @@ namespace gameModel{
 
     // Config
 
+    namespace {
+        /**
+         * Maps the broom types of the game to consecutive indices
+         * @param broom
+         * @return index of the broom or nothing if the broom type does not exist in the game
+         */
+        auto broomIndex(communication::messages::types::Broom broom) -> std::optional<std::size_t> {
+            using Broom = communication::messages::types::Broom;
+            switch (broom) {
+                case Broom::TINDERBLAST:
+                    return 0;
+                case Broom::CLEANSWEEP11:
+                    return 1;
+                case Broom::COMET260:
+                    return 2;
+                case Broom::NIMBUS2001:
+                    return 3;
+                case Broom::FIREBOLT:
+                    return 4;
+                default:
+                    return std::nullopt;
+            }
+        }
+    }
+
+    Config::Config() : maxRounds(0), foulDetectionProbs{}, gameDynamicsProbs{} {
+        updateTables();
+    }
+
     Config::Config(unsigned int maxRounds, const FoulDetectionProbs &foulDetectionProbs,
-                   const GameDynamicsProbs &gameDynamicsProbs, std::map<communication::messages::types::Broom, double> extraTurnProbs) :
-            maxRounds(maxRounds), foulDetectionProbs(foulDetectionProbs), gameDynamicsProbs(gameDynamicsProbs),
-            extraTurnProbs(std::move(extraTurnProbs)) {}
+                   const GameDynamicsProbs &gameDynamicsProbs, const std::map<communication::messages::types::Broom, double> &extraTurnProbs) :
+            maxRounds(maxRounds), foulDetectionProbs(foulDetectionProbs), gameDynamicsProbs(gameDynamicsProbs) {
+        for(const auto &[broom, prob] : extraTurnProbs){
+            setExtraTurnProb(broom, prob);
+        }
+
+        updateTables();
+    }
 
     double Config::getExtraTurnProb(communication::messages::types::Broom broom) const{
-        return extraTurnProbs.at(broom);
+        auto index = broomIndex(broom);
+        if(!index.has_value() || !knownBrooms.test(index.value())){
+            throw std::out_of_range("No extra turn probability for this broom");
+        }
+
+        return extraTurnProbs[index.value()];
+    }
+
+    void Config::setExtraTurnProb(communication::messages::types::Broom broom, double prob) {
+        auto index = broomIndex(broom);
+        if(!index.has_value()){
+            throw std::invalid_argument("Broom type does not exist in the game");
+        }
+
+        extraTurnProbs[index.value()] = prob;
+        knownBrooms.set(index.value());
+    }
+
+    double Config::getThrowSuccessProb(int distance) const {
+        if(distance >= 0 && distance <= MAX_THROW_DISTANCE){
+            return throwSuccessProbs[static_cast<std::size_t>(distance)];
+        }
+
+        return std::pow(gameDynamicsProbs.throwSuccess, distance);
+    }
+
+    double Config::getNoInterceptionProb(std::size_t interceptors) const {
+        if(interceptors <= MAX_INTERCEPTORS){
+            return noInterceptionProbs[interceptors];
+        }
+
+        return std::pow(1 - gameDynamicsProbs.catchQuaffle, interceptors);
+    }
+
+    void Config::updateTables() {
+        for(std::size_t i = 0; i < throwSuccessProbs.size(); i++){
+            throwSuccessProbs[i] = std::pow(gameDynamicsProbs.throwSuccess, i);
+        }
+
+        for(std::size_t i = 0; i < noInterceptionProbs.size(); i++){
+            noInterceptionProbs[i] = std::pow(1 - gameDynamicsProbs.catchQuaffle, i);
+        }
     }
 
     //Willste mal nen richtig großen ... KONSTRUKTOR sehen? ;)
@@ -619,11 +1481,12 @@ namespace gameModel{
         gameDynamicsProbs{config.getProbThrowSuccess(), config.getProbKnockOut(), config.getProbCatchSnitch(),
                           config.getProbCatchQuaffle(), config.getProbWrestQuaffle()}{
         using Broom = communication::messages::types::Broom;
-        extraTurnProbs.emplace(Broom::CLEANSWEEP11, config.getProbExtraCleansweep());
-        extraTurnProbs.emplace(Broom::COMET260, config.getProbExtraComet());
-        extraTurnProbs.emplace(Broom::NIMBUS2001, config.getProbExtraNimbus());
-        extraTurnProbs.emplace(Broom::FIREBOLT, config.getProbExtraFirebolt());
-        extraTurnProbs.emplace(Broom::TINDERBLAST, config.getProbExtraTinderblast());
+        setExtraTurnProb(Broom::CLEANSWEEP11, config.getProbExtraCleansweep());
+        setExtraTurnProb(Broom::COMET260, config.getProbExtraComet());
+        setExtraTurnProb(Broom::NIMBUS2001, config.getProbExtraNimbus());
+        setExtraTurnProb(Broom::FIREBOLT, config.getProbExtraFirebolt());
+        setExtraTurnProb(Broom::TINDERBLAST, config.getProbExtraTinderblast());
+        updateTables();
     }
 
     double Config::getFoulDetectionProb(Foul foul) const {
@@ -871,8 +1734,6 @@ namespace gameModel{
     }
 
     void from_json(const nlohmann::json &j, Fanblock &fanblock) {
-        fanblock.initialFans.clear();
-        fanblock.currFans.clear();
         auto tel = j.at("teleports").get<int>();
         auto ra = j.at("rangedAttacks").get<int>();
         auto imp = j.at("impulses").get<int>();
@@ -885,17 +1746,8 @@ namespace gameModel{
         auto spB = j.at("snitchPushesBanned").get<int>();
         auto bcB = j.at("blockCellsBanned").get<int>();
 
-        fanblock.currFans.emplace(InterferenceType::Teleport, tel);
-        fanblock.currFans.emplace(InterferenceType::RangedAttack, ra);
-        fanblock.currFans.emplace(InterferenceType::Impulse, imp);
-        fanblock.currFans.emplace(InterferenceType::SnitchPush, sp);
-        fanblock.currFans.emplace(InterferenceType::BlockCell, bc);
-
-        fanblock.initialFans.emplace(InterferenceType::Teleport, tel + telB);
-        fanblock.initialFans.emplace(InterferenceType::RangedAttack, ra + raB);
-        fanblock.initialFans.emplace(InterferenceType::Impulse, imp + impB);
-        fanblock.initialFans.emplace(InterferenceType::SnitchPush, sp + spB);
-        fanblock.initialFans.emplace(InterferenceType::BlockCell, bc + bcB);
+        fanblock = {tel + telB, ra + raB, imp + impB, sp + spB, bc + bcB};
+        fanblock.currFans = {ra, tel, imp, sp, bc};
     }
 
     bool Fanblock::operator==(const Fanblock &other) const {
@@ -954,19 +1806,19 @@ namespace gameModel{
         config.foulDetectionProbs.multipleOffence = j.at("multipleOffence").get<double>();
         config.foulDetectionProbs.ramming = j.at("ramming").get<double>();
 
-        config.extraTurnProbs.clear();
-        config.extraTurnProbs.emplace(Broom::CLEANSWEEP11, j.at("cleanSweepProb").get<double>());
-        config.extraTurnProbs.emplace(Broom::COMET260, j.at("cometProb").get<double>());
-        config.extraTurnProbs.emplace(Broom::NIMBUS2001, j.at("nimbusProb").get<double>());
-        config.extraTurnProbs.emplace(Broom::FIREBOLT, j.at("fireBoltProb").get<double>());
-        config.extraTurnProbs.emplace(Broom::TINDERBLAST, j.at("tinderblastProb").get<double>());
+        config.setExtraTurnProb(Broom::CLEANSWEEP11, j.at("cleanSweepProb").get<double>());
+        config.setExtraTurnProb(Broom::COMET260, j.at("cometProb").get<double>());
+        config.setExtraTurnProb(Broom::NIMBUS2001, j.at("nimbusProb").get<double>());
+        config.setExtraTurnProb(Broom::FIREBOLT, j.at("fireBoltProb").get<double>());
+        config.setExtraTurnProb(Broom::TINDERBLAST, j.at("tinderblastProb").get<double>());
+        config.updateTables();
     }
 
     bool Config::operator==(const Config &rhs) const {
         return maxRounds == rhs.maxRounds &&
                foulDetectionProbs == rhs.foulDetectionProbs &&
                gameDynamicsProbs == rhs.gameDynamicsProbs &&
-               extraTurnProbs == rhs.extraTurnProbs;
+               extraTurnProbs == rhs.extraTurnProbs && knownBrooms == rhs.knownBrooms;
     }
 
     bool Config::operator!=(const Config &rhs) const {
@@ -13,7 +13,11 @@
 #include <map>
 #include <vector>
 #include <memory>
+#include <memory_resource>
 #include <deque>
+#include <functional>
+#include <bitset>
+#include <cstdint>
 #include <SopraMessages/types.hpp>
 #include <SopraMessages/MatchConfig.hpp>
 #include <SopraMessages/TeamConfig.hpp>
@@ -22,6 +26,23 @@
 
 namespace gameModel{
     constexpr int FIELD_CENTRE_COL = 8;
+    constexpr int FIELD_WIDTH = 17;
+    constexpr int FIELD_HEIGHT = 13;
+
+    /**
+     * Bit mask over the cells of the game field. The bit of a cell is given by cellIndex
+     */
+    using CellMask = std::bitset<FIELD_WIDTH * FIELD_HEIGHT>;
+
+    /**
+     * Gets the index of the cell at position (x,y) in a CellMask
+     * @param x xPosition from left, 0 based, has to be smaller than FIELD_WIDTH
+     * @param y yPosition from bottom, 0 based, has to be smaller than FIELD_HEIGHT
+     * @return index of the cell
+     */
+    constexpr auto cellIndex(int x, int y) -> std::size_t {
+        return static_cast<std::size_t>(x * FIELD_HEIGHT + y);
+    }
 
     /**
      * Probabilities for detecting a foul
@@ -144,6 +165,15 @@ namespace gameModel{
         BlockCell
     };
 
+    constexpr std::size_t NUMBER_OF_INTERFERENCE_TYPES = 5;
+
+    /**
+     * Roles of the playable characters
+     */
+    enum class PlayerRole : char {
+        Seeker, Keeper, Beater, Chaser
+    };
+
     /**
      * Side of a team
      */
@@ -157,13 +187,18 @@ namespace gameModel{
     class Config{
     public:
 
-        Config() = default;
+        Config();
         Config(const communication::messages::broadcast::MatchConfig &config);
+        /**
+         * Ctor where all members can be specified
+         * @throws std::invalid_argument if extraTurnProbs contains a broom type that does not exist in the game
+         */
         Config(unsigned int maxRounds, const FoulDetectionProbs &foulDetectionProbs,
-               const GameDynamicsProbs &gameDynamicsProbs, std::map<communication::messages::types::Broom, double> extraTurnProbs);
+               const GameDynamicsProbs &gameDynamicsProbs, const std::map<communication::messages::types::Broom, double> &extraTurnProbs);
         /**
          * Gets the probability of an extra turn with the specified Broom type
          * @param broom
+         * @throws std::out_of_range if no probability is set for the Broom type
          * @return probability of an extra turn with the specified Broom type
          */
         double getExtraTurnProb(communication::messages::types::Broom broom) const;
@@ -194,6 +229,25 @@ namespace gameModel{
          */
         const GameDynamicsProbs &getGameDynamicsProbs() const;
 
+        /**
+         * Gets the probability that a throw over the given distance reaches its target, throwSuccess^distance.
+         * Distances on the field are read from a table built with the Config.
+         * @param distance distance of the throw in cells
+         * @return probability that the throw is not missed
+         */
+        double getThrowSuccessProb(int distance) const;
+
+        /**
+         * Gets the probability that none of the given number of players intercepts a thrown Quaffle,
+         * (1 - catchQuaffle)^interceptors. Up to MAX_INTERCEPTORS players are read from a table built with the Config.
+         * @param interceptors number of players able to intercept
+         * @return probability that the Quaffle is not intercepted
+         */
+        double getNoInterceptionProb(std::size_t interceptors) const;
+
+        static constexpr int MAX_THROW_DISTANCE = FIELD_WIDTH - 1;
+        static constexpr std::size_t MAX_INTERCEPTORS = 14;
+
         /**
          * Friend method for serialization
          */
@@ -203,10 +257,22 @@ namespace gameModel{
         bool operator!=(const Config &rhs) const;
 
     private:
+        static constexpr std::size_t NUMBER_OF_BROOMS = 5;
+
         unsigned int maxRounds;
         FoulDetectionProbs foulDetectionProbs;
         GameDynamicsProbs gameDynamicsProbs;
-        std::map<communication::messages::types::Broom, double> extraTurnProbs;
+        std::array<double, NUMBER_OF_BROOMS> extraTurnProbs{};
+        std::bitset<NUMBER_OF_BROOMS> knownBrooms; ///< brooms with a value in extraTurnProbs
+        std::array<double, MAX_THROW_DISTANCE + 1> throwSuccessProbs{}; ///< throwSuccess^distance
+        std::array<double, MAX_INTERCEPTORS + 1> noInterceptionProbs{}; ///< (1 - catchQuaffle)^interceptors
+
+        void setExtraTurnProb(communication::messages::types::Broom broom, double prob);
+
+        /**
+         * Recalculates the probability tables derived from gameDynamicsProbs
+         */
+        void updateTables();
     };
 
     /**
@@ -248,12 +314,30 @@ namespace gameModel{
         bool isFined = false;
         bool knockedOut = false;
 
-        Player() = default;
-        Player(Position position, communication::messages::types::Broom broom, communication::messages::types::EntityId id);
         bool operator==(const Player &other) const;
         bool operator!=(const Player &other) const;
 
+        /**
+         * Getter
+         * @return role of the player, determined by its concrete type
+         */
+        PlayerRole getRole() const;
+
+        /**
+         * Checks if the player is allowed to catch and hold the Quaffle
+         * @return true if the player is a Chaser or a Keeper, false otherwise
+         */
+        bool canHoldQuaffle() const;
+
         virtual ~Player() = default;
+
+    protected:
+        explicit Player(PlayerRole role);
+        Player(Position position, communication::messages::types::Broom broom, communication::messages::types::EntityId id,
+               PlayerRole role);
+
+    private:
+        PlayerRole role;
     };
 
     /**
@@ -332,14 +416,14 @@ namespace gameModel{
         void banFan(communication::messages::types::FanType fan);
 
         friend void from_json(const nlohmann::json &, Fanblock &);
+        friend struct CompactEnvironment;
 
         bool operator==(const Fanblock &other) const;
         bool operator!=(const Fanblock &other) const;
 
     private:
-        std::map<InterferenceType, int> currFans;
-        std::map<InterferenceType, const int> initialFans;
-
+        std::array<int, NUMBER_OF_INTERFERENCE_TYPES> currFans{}; ///< indexed by InterferenceType
+        std::array<int, NUMBER_OF_INTERFERENCE_TYPES> initialFans{};
     };
 
     /**
@@ -347,7 +431,7 @@ namespace gameModel{
      */
     class Chaser : public Player{
     public:
-        Chaser() = default;
+        Chaser();
         Chaser(Position position, communication::messages::types::Broom broom, communication::messages::types::EntityId id);
     };
 
@@ -356,7 +440,7 @@ namespace gameModel{
      */
     class Keeper : public Player{
     public:
-        Keeper() = default;
+        Keeper();
         Keeper(Position position, communication::messages::types::Broom broom, communication::messages::types::EntityId id);
     };
 
@@ -365,7 +449,7 @@ namespace gameModel{
      */
     class Seeker : public Player{
     public:
-        Seeker() = default;
+        Seeker();
         Seeker(Position position, communication::messages::types::Broom broom, communication::messages::types::EntityId id);
     };
 
@@ -374,7 +458,7 @@ namespace gameModel{
      */
     class Beater : public Player{
     public:
-        Beater() = default;
+        Beater();
         Beater(Position position, communication::messages::types::Broom broom, communication::messages::types::EntityId id);
     };
 
@@ -439,6 +523,31 @@ namespace gameModel{
         bool operator!=(const Snitch &other) const;
     };
 
+    /**
+     * Gets the memory resource clone() allocates the copied objects from. This is the resource installed with
+     * ScopedCloneResource or, if there is none, std::pmr::get_default_resource().
+     * @return the active resource of the calling thread
+     */
+    auto getCloneResource() -> std::pmr::memory_resource *;
+
+    /**
+     * Installs a memory resource used by clone() of the calling thread for the lifetime of this object, e.g. a
+     * std::pmr::monotonic_buffer_resource belonging to one search. All objects cloned in the meantime have to be
+     * destroyed before the resource. The previously active resource is restored on destruction. The resource is not
+     * owned and must outlive this object. Expectimax and Mcts install an arena of their own per search, Environments
+     * that have to outlive it are copied with clone(std::pmr::get_default_resource()).
+     */
+    class ScopedCloneResource {
+    public:
+        explicit ScopedCloneResource(std::pmr::memory_resource &resource);
+        ~ScopedCloneResource();
+        ScopedCloneResource(const ScopedCloneResource &) = delete;
+        auto operator=(const ScopedCloneResource &) -> ScopedCloneResource & = delete;
+
+    private:
+        std::pmr::memory_resource *previous;
+    };
+
     /**
      * Represents a Team
      */
@@ -471,6 +580,14 @@ namespace gameModel{
         Team(Seeker seeker, Keeper keeper, std::array<Beater, 2> beaters, std::array<Chaser, 3> chasers,
                 int score, Fanblock fanblock, TeamSide side);
 
+        /**
+         * Ctor taking ownership of already allocated Players
+         * @throws std::invalid_argument if the ids of the players do not match side
+         */
+        Team(std::shared_ptr<Seeker> seeker, std::shared_ptr<Keeper> keeper,
+                std::array<std::shared_ptr<Beater>, 2> beaters, std::array<std::shared_ptr<Chaser>, 3> chasers,
+                int score, Fanblock fanblock, TeamSide side);
+
         /**
          * gets all Players of the team
          * @return
@@ -498,11 +615,18 @@ namespace gameModel{
         auto getPlayerByID(communication::messages::types::EntityId id) const -> std::optional<std::shared_ptr<Player>>;
 
         /**
-         * returns a deep copy of the current Team
+         * returns a deep copy of the current Team, allocated from getCloneResource()
          * @return
          */
         auto clone() const -> std::shared_ptr<Team>;
 
+        /**
+         * returns a deep copy of the current Team
+         * @param resource the Team and its Players are allocated from this resource, which has to outlive them
+         * @return
+         */
+        auto clone(std::pmr::memory_resource *resource) const -> std::shared_ptr<Team>;
+
         /**
          * Getter
          * @return side of the team
@@ -518,6 +642,26 @@ namespace gameModel{
         TeamSide side;
     };
 
+    /**
+     * Occupancy of the game field's cells
+     */
+    struct Occupancy {
+        CellMask leftPlayers; ///< Cells occupied by players of the left team who are not banned
+        CellMask rightPlayers; ///< Cells occupied by players of the right team who are not banned
+        CellMask balls; ///< Cells occupied by the Quaffle, the Bludgers and the Snitch (if it exists)
+        CellMask blocked; ///< Cells blocked by a CubeOfShit
+
+        /**
+         * @return all cells occupied by players who are not banned
+         */
+        auto players() const -> CellMask;
+
+        /**
+         * @return all valid cells neither occupied by a player nor by a ball
+         */
+        auto free() const -> CellMask;
+    };
+
     /**
      * Represents a game state
      */
@@ -613,6 +757,18 @@ namespace gameModel{
          */
         static auto getAllValidCells() -> std::array<Position, 193>;
 
+        /**
+         * Gets a mask of all Positions which are not out of bounds
+         * @return
+         */
+        static auto getValidCellMask() -> const CellMask &;
+
+        /**
+         * Calculates the occupancy of all cells in a single pass over all objects
+         * @return
+         */
+        auto getOccupancy() const -> Occupancy;
+
         /**
          * tests if two players are in the same team.
          * @param p1 player 1.
@@ -701,6 +857,14 @@ namespace gameModel{
          */
         auto getPlayerById(communication::messages::types::EntityId id) const -> std::shared_ptr<Player>;
 
+        /**
+         * Same as getPlayerById but without creating a new reference to the player
+         * @param id
+         * @throws runtime_error when player cannot be found
+         * @return the player, valid as long as it is part of this Environment
+         */
+        auto getPlayerRef(communication::messages::types::EntityId id) const -> Player &;
+
         /**
          * get the corresponding team of a player.
          * @param player the selected player.
@@ -736,6 +900,14 @@ namespace gameModel{
          */
         auto getBallByID(const communication::messages::types::EntityId &id) const -> std::shared_ptr<Ball>;
 
+        /**
+         * Same as getBallByID but without creating a new reference to the ball
+         * @param id the id of the ball.
+         * @throws runtime_error when ball cannot be found
+         * @return the ball, valid as long as it is part of this Environment
+         */
+        auto getBallRef(communication::messages::types::EntityId id) const -> Ball &;
+
         /**
          * Removes all the cubes of shit spawned during the last round
          */
@@ -755,11 +927,54 @@ namespace gameModel{
         auto isShitOnCell(const Position &position) const -> bool;
 
         /**
-         * returns a deep copy of the current Environment
+         * returns a deep copy of the current Environment, allocated from getCloneResource()
          * @return
          */
         auto clone() const -> std::shared_ptr<Environment>;
 
+        /**
+         * returns a deep copy of the current Environment
+         * @param resource the Environment, its Teams and objects are allocated from this resource, which has to
+         * outlive them. Using a std::pmr::monotonic_buffer_resource releases all copies at once.
+         * @return
+         */
+        auto clone(std::pmr::memory_resource *resource) const -> std::shared_ptr<Environment>;
+
+        /**
+         * Creates a read only copy sharing the Teams, players, balls and cubes of shit with this Environment, which
+         * must not be modified directly either while the copy exists. The copy is changed by the given function
+         * before it is returned. The function may only use the copy on write accessors mutableTeam, mutablePlayer and
+         * mutableBall, which copy an object before it is changed, and removeShitOnCell. An object counts as shared as
+         * long as any other pointer to it exists, so pointers returned by the accessors should not be kept across
+         * further calls. Use clone() to get a copy that can be modified directly.
+         * @param modify function applying the changes to the copy
+         * @return the new Environment, allocated from getCloneResource()
+         */
+        auto fork(const std::function<void(Environment &)> &modify) const -> std::shared_ptr<const Environment>;
+
+        /**
+         * Gets a Team that may be modified without affecting other Environments. The players remain shared.
+         * @param side side of the team
+         * @return the team, copied if it is shared with another Environment
+         */
+        auto mutableTeam(TeamSide side) -> std::shared_ptr<Team>;
+
+        /**
+         * Gets a player that may be modified without affecting other Environments
+         * @param id id of the player
+         * @throws std::runtime_error if there is no such player
+         * @return the player, copied together with its team if they are shared with another Environment
+         */
+        auto mutablePlayer(communication::messages::types::EntityId id) -> std::shared_ptr<Player>;
+
+        /**
+         * Gets a ball that may be modified without affecting other Environments
+         * @param id id of the ball
+         * @throws std::runtime_error if there is no such ball
+         * @return the ball, copied if it is shared with another Environment
+         */
+        auto mutableBall(communication::messages::types::EntityId id) -> std::shared_ptr<Ball>;
+
         /**
          *
          * @param teamSide Teamside of the Player being redeployed
@@ -767,6 +982,157 @@ namespace gameModel{
          * @return list of possible Positions for redeploy
          */
         auto getFreeCellsForRedeploy(const gameModel::TeamSide &teamSide)const -> const std::vector<gameModel::Position>;
+
+        /**
+         * Calculates the 64 bit Zobrist key of the game state. The key covers player and ball positions, the fined
+         * and knocked out flags, the existence of the Snitch, all cubes of shit, the scores and the remaining fans.
+         * The Config is not part of the key.
+         * @return the key, equal for equal states
+         */
+        auto getHash() const -> std::uint64_t;
+    };
+
+    /**
+     * Zobrist keys of the single features of a game state. The key of an Environment is the xor of the keys of all
+     * its features, so a key can be updated by xoring out the old and xoring in the new value of a feature.
+     */
+    namespace zobrist {
+        /**
+         * @param id id of a player or ball
+         * @param position position of the object
+         * @throws std::invalid_argument if id is no player or ball
+         */
+        auto position(communication::messages::types::EntityId id, const Position &position) -> std::uint64_t;
+
+        /**
+         * @param id id of a player
+         * @throws std::invalid_argument if id is no player
+         */
+        auto knockedOut(communication::messages::types::EntityId id) -> std::uint64_t;
+
+        /**
+         * @param id id of a player
+         * @throws std::invalid_argument if id is no player
+         */
+        auto fined(communication::messages::types::EntityId id) -> std::uint64_t;
+
+        auto snitchExists() -> std::uint64_t;
+
+        /**
+         * Key of all cubes of shit with the same flag on one cell. Depends on the number of cubes, so stacked cubes
+         * do not cancel each other out.
+         * @param position position of the cubes
+         * @param spawnedThisRound flag of the cubes
+         * @param count number of cubes, no cubes have the key 0
+         */
+        auto cube(const Position &position, bool spawnedThisRound, std::size_t count) -> std::uint64_t;
+
+        auto score(TeamSide side, int score) -> std::uint64_t;
+
+        auto fans(TeamSide side, InterferenceType type, int uses) -> std::uint64_t;
+    }
+
+    /**
+     * Flat, trivially copyable representation of the state of an Environment. Contains no pointers and is
+     * therefore copied with a plain memcpy. The Config is not part of the state.
+     * Actions are executed against a CompactEnvironment by loading it into a scratch Environment with applyTo,
+     * which reuses the objects of the scratch Environment instead of allocating new ones.
+     */
+    struct CompactEnvironment {
+        /**
+         * Maximum number of cubes of shit. Every wombat places at most one cube per round and a cube is removed at
+         * the end of the round after the one it was placed in (see Environment::removeDeprecatedShit), so there are
+         * at most two cubes per wombat on the field. This covers eight wombats of both teams together. Fanblock does
+         * not limit the number of wombats, Environments with more cubes can not be captured.
+         */
+        static constexpr std::size_t MAX_CUBES = 16;
+        static constexpr std::size_t NUMBER_OF_FANS = 5;
+
+        /**
+         * Position of an object on the game field
+         */
+        struct CellPosition {
+            std::int8_t x = 0;
+            std::int8_t y = 0;
+
+            bool operator==(const CellPosition &other) const;
+            bool operator!=(const CellPosition &other) const;
+        };
+
+        /**
+         * State of a single player
+         */
+        struct PlayerState {
+            CellPosition position;
+            std::uint8_t id = 0; ///< EntityId of the player
+            std::uint8_t broom = 0;
+            bool isFined = false;
+            bool knockedOut = false;
+
+            bool operator==(const PlayerState &other) const;
+            bool operator!=(const PlayerState &other) const;
+        };
+
+        /**
+         * State of a team. Players are stored in the order seeker, keeper, beaters, chasers
+         */
+        struct TeamState {
+            std::array<PlayerState, 7> players;
+            std::int32_t score = 0;
+            std::array<std::uint8_t, NUMBER_OF_FANS> currFans{}; ///< indexed by InterferenceType
+            std::array<std::uint8_t, NUMBER_OF_FANS> initialFans{}; ///< indexed by InterferenceType
+            TeamSide side = TeamSide::LEFT;
+
+            bool operator==(const TeamState &other) const;
+            bool operator!=(const TeamState &other) const;
+        };
+
+        /**
+         * State of a CubeOfShit
+         */
+        struct CubeState {
+            CellPosition position;
+            bool spawnedThisRound = true;
+
+            bool operator==(const CubeState &other) const;
+            bool operator!=(const CubeState &other) const;
+        };
+
+        TeamState team1;
+        TeamState team2;
+        CellPosition quaffle;
+        CellPosition snitch;
+        std::array<CellPosition, 2> bludgers;
+        bool snitchExists = false;
+        std::uint8_t numberOfCubes = 0;
+        std::array<CubeState, MAX_CUBES> pileOfShit;
+
+        CompactEnvironment() = default;
+
+        /**
+         * Captures the state of the given Environment
+         * @param env
+         * @throws std::invalid_argument if there are more than MAX_CUBES cubes of shit on the field
+         */
+        explicit CompactEnvironment(const Environment &env);
+
+        /**
+         * Creates a new Environment with the stored state
+         * @param config the config of the new Environment
+         * @return
+         */
+        auto toEnvironment(const Config &config) const -> std::shared_ptr<Environment>;
+
+        /**
+         * Overwrites the state of an existing Environment with the stored state. The objects of env are reused,
+         * memory is only allocated if env contains less cubes of shit than the stored state.
+         * @param env Environment with the same team sides as the stored state
+         * @throws std::invalid_argument if the team sides of env do not match
+         */
+        void applyTo(Environment &env) const;
+
+        bool operator==(const CompactEnvironment &other) const;
+        bool operator!=(const CompactEnvironment &other) const;
     };
 
     void to_json(nlohmann::json &j, const Position &position);
@@ -796,6 +1162,13 @@ namespace std{
             return p.x + 17 * p.y;
         }
     };
+
+    template<>
+    struct hash<gameModel::Environment> {
+        std::size_t operator()(gameModel::Environment const& env) const {
+            return static_cast<std::size_t>(env.getHash());
+        }
+    };
 }
 
 
@@ -83,9 +83,7 @@ namespace gameController{
         }
 
         for(const auto &player : env->getAllPlayers()){
-            if(player->position == env->quaffle->position &&
-                (INSTANCE_OF(player, gameModel::Chaser) ||
-                INSTANCE_OF(player, gameModel::Keeper))) {
+            if(player->position == env->quaffle->position && player->canHoldQuaffle()) {
                 moveToAdjacent(env->quaffle, env);
                 break;
             }
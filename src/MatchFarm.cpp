@@ -0,0 +1,225 @@
+/**
+ * @file MatchFarm.cpp
+ * @date
+ * @brief Implementation of a multi threaded batch runner for complete matches.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+#include "MatchFarm.h"
+
+namespace gameController {
+
+    namespace {
+        /**
+         * Range of match indices packed into a single atomic word (first index in the upper, one past the last
+         * index in the lower 32 bits). The owner takes indices from the front, thieves split off the back half.
+         */
+        class alignas(64) RangeQueue {
+        public:
+            void reset(std::uint64_t first, std::uint64_t last) {
+                range.store(pack(first, last), std::memory_order_release);
+            }
+
+            auto pop() -> std::optional<std::uint64_t> {
+                auto current = range.load(std::memory_order_acquire);
+                while (begin(current) < end(current)) {
+                    if (range.compare_exchange_weak(current, pack(begin(current) + 1, end(current)),
+                            std::memory_order_acq_rel, std::memory_order_acquire)) {
+                        return begin(current);
+                    }
+                }
+
+                return std::nullopt;
+            }
+
+            bool stealHalf(std::uint64_t &first, std::uint64_t &last) {
+                auto current = range.load(std::memory_order_acquire);
+                while (begin(current) + 1 < end(current)) {
+                    auto mid = begin(current) + (end(current) - begin(current)) / 2;
+                    if (range.compare_exchange_weak(current, pack(begin(current), mid),
+                            std::memory_order_acq_rel, std::memory_order_acquire)) {
+                        first = mid;
+                        last = end(current);
+                        return true;
+                    }
+                }
+
+                return false;
+            }
+
+        private:
+            std::atomic<std::uint64_t> range{0};
+
+            static constexpr auto pack(std::uint64_t first, std::uint64_t last) -> std::uint64_t {
+                return first << 32u | last;
+            }
+
+            static constexpr auto begin(std::uint64_t packed) -> std::uint64_t {
+                return packed >> 32u;
+            }
+
+            static constexpr auto end(std::uint64_t packed) -> std::uint64_t {
+                return packed & 0xFFFFFFFFu;
+            }
+        };
+
+        template<std::size_t N>
+        void addBin(std::array<std::uint64_t, N> &histogram, std::size_t bin) {
+            histogram[std::min(bin, N - 1)]++;
+        }
+
+        template<typename T, std::size_t N>
+        void addArray(std::array<T, N> &lhs, const std::array<T, N> &rhs) {
+            for (std::size_t i = 0; i < N; i++) {
+                lhs[i] += rhs[i];
+            }
+        }
+    }
+
+    void FarmStatistics::add(const MatchResult &result) {
+        matches++;
+        if (result.getWinner() == gameModel::TeamSide::LEFT) {
+            winsLeft++;
+        } else {
+            winsRight++;
+        }
+
+        if (result.snitchCaughtBy == gameModel::TeamSide::LEFT) {
+            snitchCatchesLeft++;
+        } else {
+            snitchCatchesRight++;
+        }
+
+        totalScoreLeft += static_cast<std::uint64_t>(result.scoreLeft);
+        totalScoreRight += static_cast<std::uint64_t>(result.scoreRight);
+        addBin(scoreLeft, static_cast<std::size_t>(result.scoreLeft / GOAL_POINTS));
+        addBin(scoreRight, static_cast<std::size_t>(result.scoreRight / GOAL_POINTS));
+        addBin(snitchCatchRound, result.rounds);
+        for (std::size_t i = 0; i < fouls.size(); i++) {
+            fouls[i] += result.fouls[i];
+        }
+
+        fanBansLeft += static_cast<std::uint64_t>(result.fanBansLeft);
+        fanBansRight += static_cast<std::uint64_t>(result.fanBansRight);
+    }
+
+    auto FarmStatistics::getWinRate(gameModel::TeamSide side) const -> double {
+        if (matches == 0) {
+            return 0;
+        }
+
+        return static_cast<double>(side == gameModel::TeamSide::LEFT ? winsLeft : winsRight) / matches;
+    }
+
+    auto FarmStatistics::operator+=(const FarmStatistics &other) -> FarmStatistics & {
+        matches += other.matches;
+        winsLeft += other.winsLeft;
+        winsRight += other.winsRight;
+        snitchCatchesLeft += other.snitchCatchesLeft;
+        snitchCatchesRight += other.snitchCatchesRight;
+        totalScoreLeft += other.totalScoreLeft;
+        totalScoreRight += other.totalScoreRight;
+        addArray(scoreLeft, other.scoreLeft);
+        addArray(scoreRight, other.scoreRight);
+        addArray(snitchCatchRound, other.snitchCatchRound);
+        addArray(fouls, other.fouls);
+        fanBansLeft += other.fanBansLeft;
+        fanBansRight += other.fanBansRight;
+        return *this;
+    }
+
+    bool FarmStatistics::operator==(const FarmStatistics &other) const {
+        return matches == other.matches && winsLeft == other.winsLeft && winsRight == other.winsRight &&
+               snitchCatchesLeft == other.snitchCatchesLeft && snitchCatchesRight == other.snitchCatchesRight &&
+               totalScoreLeft == other.totalScoreLeft && totalScoreRight == other.totalScoreRight &&
+               scoreLeft == other.scoreLeft && scoreRight == other.scoreRight &&
+               snitchCatchRound == other.snitchCatchRound && fouls == other.fouls &&
+               fanBansLeft == other.fanBansLeft && fanBansRight == other.fanBansRight;
+    }
+
+    bool FarmStatistics::operator!=(const FarmStatistics &other) const {
+        return !(*this == other);
+    }
+
+    MatchFarm::MatchFarm(std::shared_ptr<const gameModel::Environment> initialEnv, Policy leftPolicy,
+            Policy rightPolicy, unsigned int threads) : initialEnv(std::move(initialEnv)),
+            leftPolicy(std::move(leftPolicy)), rightPolicy(std::move(rightPolicy)),
+            threads(threads != 0 ? threads : std::max(1u, std::thread::hardware_concurrency())) {}
+
+    auto MatchFarm::run(std::uint64_t matches, std::uint64_t seed) const -> FarmStatistics {
+        if (matches > std::numeric_limits<std::uint32_t>::max()) {
+            throw std::invalid_argument("Too many matches");
+        }
+
+        std::vector<RangeQueue> queues(threads);
+        for (unsigned int i = 0; i < threads; i++) {
+            queues[i].reset(matches * i / threads, matches * (i + 1) / threads);
+        }
+
+        std::vector<FarmStatistics> statistics(threads);
+        std::vector<std::exception_ptr> errors(threads);
+        std::atomic<bool> abort{false};
+        auto work = [&](unsigned int self) {
+            try {
+                MatchSimulator simulator(initialEnv, leftPolicy, rightPolicy);
+                FarmStatistics local;
+                while (!abort.load(std::memory_order_relaxed)) {
+                    auto index = queues[self].pop();
+                    if (index.has_value()) {
+                        local.add(simulator.run(seed + index.value()));
+                        continue;
+                    }
+
+                    bool stolen = false;
+                    for (unsigned int offset = 1; offset < threads && !stolen; offset++) {
+                        std::uint64_t first = 0;
+                        std::uint64_t last = 0;
+                        if (queues[(self + offset) % threads].stealHalf(first, last)) {
+                            queues[self].reset(first, last);
+                            stolen = true;
+                        }
+                    }
+
+                    if (!stolen) {
+                        break;
+                    }
+                }
+
+                statistics[self] = local;
+            } catch (...) {
+                errors[self] = std::current_exception();
+                abort.store(true, std::memory_order_relaxed);
+            }
+        };
+
+        std::vector<std::thread> workers;
+        for (unsigned int i = 1; i < threads; i++) {
+            workers.emplace_back(work, i);
+        }
+
+        work(0);
+        for (auto &worker : workers) {
+            worker.join();
+        }
+
+        FarmStatistics ret;
+        for (unsigned int i = 0; i < threads; i++) {
+            if (errors[i]) {
+                std::rethrow_exception(errors[i]);
+            }
+
+            ret += statistics[i];
+        }
+
+        return ret;
+    }
+
+    auto MatchFarm::getThreads() const -> unsigned int {
+        return threads;
+    }
+}
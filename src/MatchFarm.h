@@ -0,0 +1,99 @@
+/**
+ * @file MatchFarm.h
+ * @date
+ * @brief Declaration of a multi threaded batch runner for complete matches.
+ */
+
+#ifndef SOPRAGAMELOGIC_MATCHFARM_H
+#define SOPRAGAMELOGIC_MATCHFARM_H
+
+#include <array>
+#include <cstdint>
+#include <memory>
+
+#include "MatchSimulator.h"
+
+namespace gameController {
+
+    /**
+     * Aggregated results of many matches
+     */
+    struct FarmStatistics {
+        static constexpr std::size_t SCORE_BINS = 32;
+        static constexpr std::size_t ROUND_BINS = 64;
+
+        std::uint64_t matches = 0;
+        std::uint64_t winsLeft = 0;
+        std::uint64_t winsRight = 0;
+        std::uint64_t snitchCatchesLeft = 0;
+        std::uint64_t snitchCatchesRight = 0;
+        std::uint64_t totalScoreLeft = 0;
+        std::uint64_t totalScoreRight = 0;
+        std::array<std::uint64_t, SCORE_BINS> scoreLeft{}; ///< histogram of the scores in steps of 10 points, the last bin also counts all higher scores
+        std::array<std::uint64_t, SCORE_BINS> scoreRight{}; ///< see scoreLeft
+        std::array<std::uint64_t, ROUND_BINS> snitchCatchRound{}; ///< histogram of the round in which the Snitch was caught, the last bin also counts all later rounds
+        std::array<std::uint64_t, MatchResult::NUMBER_OF_FOULS> fouls{}; ///< detected fouls of players, indexed by gameModel::Foul
+        std::uint64_t fanBansLeft = 0;
+        std::uint64_t fanBansRight = 0;
+
+        /**
+         * Adds the result of a single match
+         * @param result the result
+         */
+        void add(const MatchResult &result);
+
+        /**
+         * Gets the ratio of won matches
+         * @param side the team
+         * @return number of won matches divided by the number of matches, 0 if no match was played
+         */
+        auto getWinRate(gameModel::TeamSide side) const -> double;
+
+        auto operator+=(const FarmStatistics &other) -> FarmStatistics &;
+        bool operator==(const FarmStatistics &other) const;
+        bool operator!=(const FarmStatistics &other) const;
+    };
+
+    /**
+     * Plays independent matches on several threads. The matches are distributed by a lock free work stealing
+     * scheduler, every worker owns a MatchSimulator with its own copies of the policies and aggregates its results
+     * locally. The statistics of the workers are merged once all matches are played.
+     */
+    class MatchFarm {
+    public:
+        /**
+         * Constructs a farm starting every match at the given state
+         * @param initialEnv state at the beginning of every match, is not modified
+         * @param leftPolicy decisions of the left team, copied for every worker
+         * @param rightPolicy decisions of the right team, copied for every worker
+         * @param threads number of workers, 0 for one worker per hardware thread
+         */
+        MatchFarm(std::shared_ptr<const gameModel::Environment> initialEnv, Policy leftPolicy, Policy rightPolicy,
+                unsigned int threads = 0);
+
+        /**
+         * Plays the given number of matches. The i-th match is played with the engine seed seed + i, so the
+         * statistics only depend on the seed and not on the number of threads or the scheduling.
+         * @param matches number of matches, at most 2^32 - 1
+         * @param seed seed of the first match
+         * @throws std::invalid_argument if matches is too large
+         * @throws std::runtime_error if a policy chooses an impossible action or interference
+         * @return the aggregated statistics
+         */
+        auto run(std::uint64_t matches, std::uint64_t seed) const -> FarmStatistics;
+
+        /**
+         * Getter
+         * @return the number of workers
+         */
+        auto getThreads() const -> unsigned int;
+
+    private:
+        std::shared_ptr<const gameModel::Environment> initialEnv;
+        Policy leftPolicy;
+        Policy rightPolicy;
+        unsigned int threads;
+    };
+}
+
+#endif //SOPRAGAMELOGIC_MATCHFARM_H
@@ -0,0 +1,301 @@
+/**
+ * @file MatchSimulator.cpp
+ * @date
+ * @brief Implementation of a headless engine playing complete matches.
+ */
+
+#include <algorithm>
+#include "MatchSimulator.h"
+
+namespace gameController {
+
+    namespace {
+        template<typename T>
+        auto pickRandom(const std::vector<T> &values) -> const T & {
+            return values[rng(0, static_cast<int>(values.size()) - 1)];
+        }
+
+        auto otherSide(gameModel::TeamSide side) -> gameModel::TeamSide {
+            return side == gameModel::TeamSide::LEFT ? gameModel::TeamSide::RIGHT : gameModel::TeamSide::LEFT;
+        }
+    }
+
+    auto randomPolicy() -> Policy {
+        Policy policy;
+        policy.move = [](const std::shared_ptr<gameModel::Environment> &env,
+                const std::shared_ptr<gameModel::Player> &player) -> std::optional<gameModel::Position> {
+            std::vector<gameModel::Position> targets;
+            for (const auto &pos : gameModel::Environment::getSurroundingPositions(player->position)) {
+                if (Move(env, player, pos).check() != ActionCheckResult::Impossible) {
+                    targets.emplace_back(pos);
+                }
+            }
+
+            if (targets.empty()) {
+                return std::nullopt;
+            }
+
+            return pickRandom(targets);
+        };
+
+        policy.action = [](const std::shared_ptr<gameModel::Environment> &env,
+                const std::shared_ptr<gameModel::Player> &player, ActionType type) -> std::shared_ptr<Action> {
+            if (type == ActionType::Wrest) {
+                return std::make_shared<WrestQuaffle>(env, std::static_pointer_cast<gameModel::Chaser>(player),
+                        env->quaffle->position);
+            }
+
+            auto shots = getAllConstrainedShots(player, env);
+            if (shots.empty()) {
+                return nullptr;
+            }
+
+            auto shot = std::make_shared<Shot>(pickRandom(shots));
+            return shot->check() == ActionCheckResult::Impossible ? nullptr : shot;
+        };
+
+        policy.fan = [](const std::shared_ptr<gameModel::Environment> &env, const std::shared_ptr<gameModel::Team> &team,
+                gameModel::InterferenceType type) -> std::shared_ptr<Interference> {
+            std::shared_ptr<Interference> interference;
+            switch (type) {
+                case gameModel::InterferenceType::Teleport:
+                case gameModel::InterferenceType::RangedAttack: {
+                    auto opponents = env->getTeam(otherSide(team->getSide()))->getAllPlayers();
+                    auto target = opponents[rng(0, static_cast<int>(opponents.size()) - 1)];
+                    if (type == gameModel::InterferenceType::Teleport) {
+                        interference = std::make_shared<Teleport>(env, team, target);
+                    } else {
+                        interference = std::make_shared<RangedAttack>(env, team, target);
+                    }
+                    break;
+                }
+                case gameModel::InterferenceType::Impulse:
+                    interference = std::make_shared<Impulse>(env, team);
+                    break;
+                case gameModel::InterferenceType::SnitchPush:
+                    interference = std::make_shared<SnitchPush>(env, team);
+                    break;
+                case gameModel::InterferenceType::BlockCell: {
+                    auto cells = env->getAllFreeCells();
+                    if (cells.empty()) {
+                        return nullptr;
+                    }
+
+                    interference = std::make_shared<BlockCell>(env, team, pickRandom(cells));
+                    break;
+                }
+            }
+
+            return interference->isPossible() ? interference : nullptr;
+        };
+
+        policy.unban = [](const std::shared_ptr<gameModel::Environment> &, const std::shared_ptr<gameModel::Player> &,
+                const std::vector<gameModel::Position> &cells) {
+            return pickRandom(cells);
+        };
+
+        return policy;
+    }
+
+    auto getExcessLength(unsigned int round, unsigned int maxRounds) -> ExcessLength {
+        if (round <= maxRounds) {
+            return ExcessLength::None;
+        }
+
+        auto overtimeRound = round - maxRounds - 1;
+        if (overtimeRound < OVERTIME_STAGE_ROUNDS) {
+            return ExcessLength::Stage1;
+        } else if (overtimeRound < 2 * OVERTIME_STAGE_ROUNDS) {
+            return ExcessLength::Stage2;
+        } else {
+            return ExcessLength::Stage3;
+        }
+    }
+
+    auto MatchResult::getWinner() const -> gameModel::TeamSide {
+        if (scoreLeft == scoreRight) {
+            return snitchCaughtBy;
+        }
+
+        return scoreLeft > scoreRight ? gameModel::TeamSide::LEFT : gameModel::TeamSide::RIGHT;
+    }
+
+    MatchSimulator::MatchSimulator(const communication::messages::broadcast::MatchConfig &matchConfig,
+            const communication::messages::request::TeamConfig &leftConfig,
+            const communication::messages::request::TeamFormation &leftFormation,
+            const communication::messages::request::TeamConfig &rightConfig,
+            const communication::messages::request::TeamFormation &rightFormation,
+            Policy leftPolicy, Policy rightPolicy) :
+            MatchSimulator(std::make_shared<const gameModel::Environment>(matchConfig, leftConfig, rightConfig,
+                    leftFormation, rightFormation), std::move(leftPolicy), std::move(rightPolicy)) {}
+
+    MatchSimulator::MatchSimulator(std::shared_ptr<const gameModel::Environment> initialEnv, Policy leftPolicy,
+            Policy rightPolicy) : initialEnv(std::move(initialEnv)), leftPolicy(std::move(leftPolicy)),
+            rightPolicy(std::move(rightPolicy)) {}
+
+    auto MatchSimulator::run() -> MatchResult {
+        env.reset();
+        arena.release();
+        env = initialEnv->clone(&arena);
+        snitchCaughtBy.reset();
+        fouls = {};
+        MatchResult result;
+        for (unsigned int round = 1; !snitchCaughtBy.has_value(); round++) {
+            result.rounds = round;
+            ballPhase(round);
+            if (snitchCaughtBy.has_value()) {
+                break;
+            }
+
+            fanPhase();
+            playerPhase();
+            if (snitchCaughtBy.has_value()) {
+                break;
+            }
+
+            unbanPhase();
+            env->removeDeprecatedShit();
+        }
+
+        result.scoreLeft = env->team1->score;
+        result.scoreRight = env->team2->score;
+        result.snitchCaughtBy = snitchCaughtBy.value();
+        result.fouls = fouls;
+        for (auto type : {gameModel::InterferenceType::RangedAttack, gameModel::InterferenceType::Teleport,
+                          gameModel::InterferenceType::Impulse, gameModel::InterferenceType::SnitchPush,
+                          gameModel::InterferenceType::BlockCell}) {
+            result.fanBansLeft += env->team1->fanblock.getBannedCount(type);
+            result.fanBansRight += env->team2->fanblock.getBannedCount(type);
+        }
+
+        return result;
+    }
+
+    auto MatchSimulator::run(std::uint64_t seed) -> MatchResult {
+        Xoshiro256 engine(seed);
+        ScopedRng scope(engine);
+        return run();
+    }
+
+    auto MatchSimulator::getEnvironment() const -> const gameModel::Environment & {
+        return env ? *env : *initialEnv;
+    }
+
+    auto MatchSimulator::getPolicy(const std::shared_ptr<const gameModel::Player> &player) const -> const Policy & {
+        return env->team1->hasMember(player) ? leftPolicy : rightPolicy;
+    }
+
+    void MatchSimulator::ballPhase(unsigned int round) {
+        if (!env->snitch->exists && round >= SNITCH_SPAWN_ROUND) {
+            spawnSnitch(env);
+        } else if (env->snitch->exists &&
+                   moveSnitch(env->snitch, env, getExcessLength(round, env->config.getMaxRounds()))) {
+            auto seeker = env->getPlayer(env->snitch->position);
+            snitchCaughtBy = env->getTeam(seeker.value())->getSide();
+            return;
+        }
+
+        for (auto &bludger : env->bludgers) {
+            moveBludger(bludger, env);
+        }
+    }
+
+    void MatchSimulator::fanPhase() {
+        std::vector<std::pair<std::shared_ptr<gameModel::Team>, gameModel::InterferenceType>> turns;
+        for (const auto &team : {env->team1, env->team2}) {
+            for (auto type : {gameModel::InterferenceType::RangedAttack, gameModel::InterferenceType::Teleport,
+                              gameModel::InterferenceType::Impulse, gameModel::InterferenceType::SnitchPush,
+                              gameModel::InterferenceType::BlockCell}) {
+                for (int i = 0; i < team->fanblock.getUses(type); i++) {
+                    turns.emplace_back(team, type);
+                }
+            }
+        }
+
+        std::shuffle(turns.begin(), turns.end(), getRng());
+        for (const auto &[team, type] : turns) {
+            const auto &policy = team == env->team1 ? leftPolicy : rightPolicy;
+            auto interference = policy.fan(env, team, type);
+            if (interference) {
+                interference->execute();
+            }
+        }
+    }
+
+    void MatchSimulator::playerPhase() {
+        auto leftPlayers = env->team1->getAllPlayers();
+        auto rightPlayers = env->team2->getAllPlayers();
+        std::shuffle(leftPlayers.begin(), leftPlayers.end(), getRng());
+        std::shuffle(rightPlayers.begin(), rightPlayers.end(), getRng());
+        const bool leftFirst = rng(0, 1) == 0;
+        for (std::size_t i = 0; i < 2 * leftPlayers.size(); i++) {
+            const auto &player = (i % 2 == 0) == leftFirst ? leftPlayers[i / 2] : rightPlayers[i / 2];
+            if (player->isFined) {
+                continue;
+            }
+
+            if (player->knockedOut) {
+                player->knockedOut = false;
+                continue;
+            }
+
+            moveTurn(player);
+            if (!snitchCaughtBy.has_value() && !player->isFined &&
+                actionTriggered(env->config.getExtraTurnProb(player->broom))) {
+                moveTurn(player);
+            }
+
+            if (!snitchCaughtBy.has_value() && !player->isFined) {
+                actionTurn(player);
+            }
+
+            if (snitchCaughtBy.has_value()) {
+                return;
+            }
+        }
+    }
+
+    void MatchSimulator::unbanPhase() {
+        for (const auto &player : env->getAllPlayers()) {
+            if (player->isFined) {
+                auto cells = env->getFreeCellsForRedeploy(env->getTeam(player)->getSide());
+                player->position = getPolicy(player).unban(env, player, cells);
+                player->isFined = false;
+            }
+        }
+    }
+
+    void MatchSimulator::moveTurn(const std::shared_ptr<gameModel::Player> &player) {
+        auto target = getPolicy(player).move(env, player);
+        if (target.has_value()) {
+            handleResults(Move(env, player, target.value()).execute(), player);
+        }
+    }
+
+    void MatchSimulator::actionTurn(const std::shared_ptr<gameModel::Player> &player) {
+        auto type = getPossibleBallActionType(player, env);
+        if (!type.has_value()) {
+            return;
+        }
+
+        auto action = getPolicy(player).action(env, player, type.value());
+        if (action) {
+            handleResults(action->execute(), player);
+        }
+    }
+
+    void MatchSimulator::handleResults(const std::pair<std::vector<ActionResult>, std::vector<gameModel::Foul>> &results,
+            const std::shared_ptr<gameModel::Player> &actor) {
+        for (const auto &foul : results.second) {
+            fouls[static_cast<std::size_t>(foul)]++;
+        }
+
+        for (const auto &result : results.first) {
+            if (result == ActionResult::ScoreLeft || result == ActionResult::ScoreRight) {
+                moveQuaffelAfterGoal(env);
+            } else if (result == ActionResult::SnitchCatch) {
+                snitchCaughtBy = env->getTeam(actor)->getSide();
+            }
+        }
+    }
+}
@@ -0,0 +1,176 @@
+/**
+ * @file MatchSimulator.h
+ * @date
+ * @brief Declaration of a headless engine playing complete matches.
+ */
+
+#ifndef SOPRAGAMELOGIC_MATCHSIMULATOR_H
+#define SOPRAGAMELOGIC_MATCHSIMULATOR_H
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <vector>
+
+#include "GameModel.h"
+#include "GameController.h"
+#include "Interference.h"
+
+namespace gameController {
+
+    constexpr unsigned int SNITCH_SPAWN_ROUND = 13;
+    constexpr unsigned int OVERTIME_STAGE_ROUNDS = 3;
+
+    /**
+     * Decisions of one team. Every callback receives the current state of the match and must not modify it.
+     * Environments cloned by a callback are allocated from the clone resource of the thread running the match.
+     */
+    struct Policy {
+        /**
+         * Chooses the target of a move turn of the given player
+         * @return the target cell or nothing to skip the turn
+         */
+        std::function<std::optional<gameModel::Position>(const std::shared_ptr<gameModel::Environment> &,
+                const std::shared_ptr<gameModel::Player> &)> move;
+
+        /**
+         * Chooses the ball action (Shot or WrestQuaffle) of an action turn of the given player
+         * @return the action or nullptr to skip the turn
+         */
+        std::function<std::shared_ptr<Action>(const std::shared_ptr<gameModel::Environment> &,
+                const std::shared_ptr<gameModel::Player> &, ActionType)> action;
+
+        /**
+         * Chooses the interference of a fan of the given type
+         * @return the interference or nullptr to skip the turn
+         */
+        std::function<std::shared_ptr<Interference>(const std::shared_ptr<gameModel::Environment> &,
+                const std::shared_ptr<gameModel::Team> &, gameModel::InterferenceType)> fan;
+
+        /**
+         * Chooses where a banned player is placed when the ban is lifted
+         * @return one of the given cells
+         */
+        std::function<gameModel::Position(const std::shared_ptr<gameModel::Environment> &,
+                const std::shared_ptr<gameModel::Player> &, const std::vector<gameModel::Position> &)> unban;
+    };
+
+    /**
+     * Policy choosing uniformly at random between all possible moves, shots and interferences. Never skips a turn
+     * if there is a possible choice. Draws from the active engine (see getRng).
+     * @return the policy
+     */
+    auto randomPolicy() -> Policy;
+
+    /**
+     * Gets the overtime stage of a round. Overtime starts after the maximum number of rounds, each stage except
+     * the last lasts OVERTIME_STAGE_ROUNDS rounds.
+     * @param round the round, starting at 1
+     * @param maxRounds the maximum number of rounds before overtime
+     * @return the overtime stage, ExcessLength::None if the round is no overtime round
+     */
+    auto getExcessLength(unsigned int round, unsigned int maxRounds) -> ExcessLength;
+
+    /**
+     * Result of a complete match
+     */
+    struct MatchResult {
+        static constexpr std::size_t NUMBER_OF_FOULS = 6;
+
+        int scoreLeft = 0;
+        int scoreRight = 0;
+        unsigned int rounds = 0; ///< number of rounds played, including the round in which the Snitch was caught
+        gameModel::TeamSide snitchCaughtBy = gameModel::TeamSide::LEFT;
+        std::array<unsigned int, NUMBER_OF_FOULS> fouls{}; ///< detected fouls of players, indexed by gameModel::Foul
+        int fanBansLeft = 0; ///< banned fans of the left team
+        int fanBansRight = 0; ///< banned fans of the right team
+
+        /**
+         * Gets the winner of the match: the team with more points or the team which caught the Snitch on a draw
+         * @return side of the winning team
+         */
+        auto getWinner() const -> gameModel::TeamSide;
+    };
+
+    /**
+     * Plays complete matches without a server. Every round consists of the ball phase (Snitch spawn or Snitch
+     * move, Bludger moves), the fan phase, the player phase and the unban phase, followed by the removal of
+     * deprecated cubes of shit. The match ends as soon as the Snitch is caught.
+     * The state of a match is cloned into an arena of the simulator which is released as a whole when the next
+     * match starts.
+     */
+    class MatchSimulator {
+    public:
+        /**
+         * Constructs a simulator from server config types
+         * @param matchConfig config of the match
+         * @param leftConfig config of the left team
+         * @param leftFormation initial positions of the left team
+         * @param rightConfig config of the right team
+         * @param rightFormation initial positions of the right team
+         * @param leftPolicy decisions of the left team
+         * @param rightPolicy decisions of the right team
+         */
+        MatchSimulator(const communication::messages::broadcast::MatchConfig &matchConfig,
+                const communication::messages::request::TeamConfig &leftConfig,
+                const communication::messages::request::TeamFormation &leftFormation,
+                const communication::messages::request::TeamConfig &rightConfig,
+                const communication::messages::request::TeamFormation &rightFormation,
+                Policy leftPolicy, Policy rightPolicy);
+
+        /**
+         * Constructs a simulator starting every match at the given state
+         * @param initialEnv state at the beginning of every match, is not modified
+         * @param leftPolicy decisions of the left team
+         * @param rightPolicy decisions of the right team
+         */
+        MatchSimulator(std::shared_ptr<const gameModel::Environment> initialEnv, Policy leftPolicy, Policy rightPolicy);
+
+        /**
+         * Plays a complete match drawing from the active engine of the calling thread
+         * @throws std::runtime_error if a policy chooses an impossible action or interference
+         * @return the result of the match
+         */
+        auto run() -> MatchResult;
+
+        /**
+         * Plays a reproducible match with its own engine. Matches with the same seed and deterministic policies
+         * have the same result.
+         * @param seed seed of the engine of the match
+         * @throws std::runtime_error if a policy chooses an impossible action or interference
+         * @return the result of the match
+         */
+        auto run(std::uint64_t seed) -> MatchResult;
+
+        /**
+         * Getter
+         * @return the final state of the last match or the initial state if no match was played. The final state
+         * is only valid until the next match is started or the simulator is destroyed, use clone() to keep it longer.
+         */
+        auto getEnvironment() const -> const gameModel::Environment &;
+
+    private:
+        std::shared_ptr<const gameModel::Environment> initialEnv;
+        Policy leftPolicy;
+        Policy rightPolicy;
+        std::pmr::monotonic_buffer_resource arena; ///< state of the current match, declared before env to outlive it
+        std::shared_ptr<gameModel::Environment> env;
+        std::optional<gameModel::TeamSide> snitchCaughtBy;
+        std::array<unsigned int, MatchResult::NUMBER_OF_FOULS> fouls{};
+
+        auto getPolicy(const std::shared_ptr<const gameModel::Player> &player) const -> const Policy &;
+        void ballPhase(unsigned int round);
+        void fanPhase();
+        void playerPhase();
+        void unbanPhase();
+        void moveTurn(const std::shared_ptr<gameModel::Player> &player);
+        void actionTurn(const std::shared_ptr<gameModel::Player> &player);
+        void handleResults(const std::pair<std::vector<ActionResult>, std::vector<gameModel::Foul>> &results,
+                const std::shared_ptr<gameModel::Player> &actor);
+    };
+}
+
+#endif //SOPRAGAMELOGIC_MATCHSIMULATOR_H
@@ -0,0 +1,401 @@
+/**
+ * @file Mcts.cpp
+ * @date
+ * @brief Implementation of a parallel Monte Carlo tree search.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <limits>
+#include <memory_resource>
+#include <stdexcept>
+#include <thread>
+#include "Mcts.h"
+#include "conversions.h"
+
+namespace gameController {
+
+    namespace {
+        constexpr std::uint32_t NO_NODE = std::numeric_limits<std::uint32_t>::max();
+
+        void atomicAdd(std::atomic<double> &target, double value) {
+            auto current = target.load(std::memory_order_relaxed);
+            while (!target.compare_exchange_weak(current, current + value, std::memory_order_relaxed)) {}
+        }
+
+        auto ballAt(const gameModel::Environment &env, const gameModel::Position &position) ->
+            std::shared_ptr<gameModel::Ball> {
+            if (env.quaffle->position == position) {
+                return env.quaffle;
+            } else if (env.bludgers[0]->position == position) {
+                return env.bludgers[0];
+            } else if (env.bludgers[1]->position == position) {
+                return env.bludgers[1];
+            }
+
+            return nullptr;
+        }
+
+        auto generateKeys(const std::shared_ptr<gameModel::Environment> &env,
+                const std::shared_ptr<gameModel::Player> &actor) -> std::vector<ActionKey> {
+            std::vector<ActionKey> keys;
+            if (!actor->isFined && !actor->knockedOut) {
+                for (const auto &move : getAllPossibleMoves(actor, env)) {
+                    if (move.check() != ActionCheckResult::Impossible) {
+                        keys.push_back({ActionKey::Kind::Move, move.getTarget()});
+                    }
+                }
+
+                auto type = getPossibleBallActionType(actor, env);
+                if (type == ActionType::Throw) {
+                    for (const auto &shot : getAllConstrainedShots(actor, env)) {
+                        if (shot.check() != ActionCheckResult::Impossible) {
+                            keys.push_back({ActionKey::Kind::Shot, shot.getTarget()});
+                        }
+                    }
+                } else if (type == ActionType::Wrest) {
+                    keys.push_back({ActionKey::Kind::Wrest, env->quaffle->position});
+                }
+            }
+
+            // the shot generator may yield a target more than once
+            for (auto it = keys.begin(); it != keys.end(); it++) {
+                keys.erase(std::remove(std::next(it), keys.end(), *it), keys.end());
+            }
+
+            if (keys.empty()) {
+                keys.push_back({ActionKey::Kind::Pass, {}});
+            }
+
+            return keys;
+        }
+
+        auto createAction(const std::shared_ptr<gameModel::Environment> &env,
+                const std::shared_ptr<gameModel::Player> &actor, const ActionKey &key) -> std::shared_ptr<Action> {
+            switch (key.kind) {
+                case ActionKey::Kind::Move:
+                    return std::make_shared<Move>(env, actor, key.target);
+                case ActionKey::Kind::Shot:
+                    return std::make_shared<Shot>(env, actor, ballAt(*env, actor->position), key.target);
+                case ActionKey::Kind::Wrest:
+                    return std::make_shared<WrestQuaffle>(env, std::static_pointer_cast<gameModel::Chaser>(actor),
+                            key.target);
+                default:
+                    return nullptr;
+            }
+        }
+
+        bool isPossible(const std::shared_ptr<gameModel::Environment> &env,
+                const std::shared_ptr<gameModel::Player> &actor, const ActionKey &key) {
+            const bool canAct = !actor->isFined && !actor->knockedOut;
+            switch (key.kind) {
+                case ActionKey::Kind::Pass:
+                    return true;
+                case ActionKey::Kind::Move:
+                    return Move(env, actor, key.target).check() != ActionCheckResult::Impossible;
+                case ActionKey::Kind::Shot:
+                    return canAct && getPossibleBallActionType(actor, env) == ActionType::Throw &&
+                           Shot(env, actor, ballAt(*env, actor->position), key.target).check() !=
+                           ActionCheckResult::Impossible;
+                case ActionKey::Kind::Wrest:
+                    return canAct && getPossibleBallActionType(actor, env) == ActionType::Wrest &&
+                           env->quaffle->position == key.target;
+            }
+
+            return false;
+        }
+
+        void execute(const std::shared_ptr<gameModel::Environment> &env,
+                const std::shared_ptr<gameModel::Player> &actor, const ActionKey &key) {
+            switch (key.kind) {
+                case ActionKey::Kind::Move:
+                    Move(env, actor, key.target).execute();
+                    break;
+                case ActionKey::Kind::Shot:
+                    Shot(env, actor, ballAt(*env, actor->position), key.target).execute();
+                    break;
+                case ActionKey::Kind::Wrest:
+                    WrestQuaffle(env, std::static_pointer_cast<gameModel::Chaser>(actor), key.target).execute();
+                    break;
+                case ActionKey::Kind::Pass:
+                    break;
+            }
+        }
+    }
+
+    bool ActionKey::operator==(const ActionKey &other) const {
+        return kind == other.kind && target == other.target;
+    }
+
+    bool ActionKey::operator!=(const ActionKey &other) const {
+        return !(*this == other);
+    }
+
+    MctsNodePool::MctsNodePool(std::size_t capacity) : nodes(std::make_unique<MctsNode[]>(capacity)),
+        maxNodes(capacity) {}
+
+    auto MctsNodePool::allocate(std::uint32_t count) -> std::optional<std::uint32_t> {
+        auto first = used.fetch_add(count, std::memory_order_relaxed);
+        if (first + count > maxNodes) {
+            return std::nullopt;
+        }
+
+        for (auto i = first; i < first + count; i++) {
+            auto &node = nodes[i];
+            node.visits.store(0, std::memory_order_relaxed);
+            node.virtualLoss.store(0, std::memory_order_relaxed);
+            node.rewardSum.store(0, std::memory_order_relaxed);
+            node.firstChild.store(0, std::memory_order_relaxed);
+            node.numberOfChildren.store(0, std::memory_order_relaxed);
+            node.state.store(MctsNode::Unexpanded, std::memory_order_relaxed);
+        }
+
+        return static_cast<std::uint32_t>(first);
+    }
+
+    void MctsNodePool::reset() {
+        used.store(0, std::memory_order_relaxed);
+    }
+
+    auto MctsNodePool::operator[](std::uint32_t index) -> MctsNode & {
+        return nodes[index];
+    }
+
+    auto MctsNodePool::operator[](std::uint32_t index) const -> const MctsNode & {
+        return nodes[index];
+    }
+
+    auto MctsNodePool::size() const -> std::size_t {
+        return std::min(used.load(std::memory_order_relaxed), maxNodes);
+    }
+
+    auto MctsNodePool::capacity() const -> std::size_t {
+        return maxNodes;
+    }
+
+    struct Mcts::Context {
+        gameModel::CompactEnvironment root;
+        std::vector<communication::messages::types::EntityId> turnOrder;
+        gameModel::TeamSide rootSide;
+    };
+
+    Mcts::Mcts(Evaluation evaluation, double minValue, double maxValue, Options options) :
+        evaluation(std::move(evaluation)), minValue(minValue), maxValue(maxValue), options(options) {
+        if (minValue >= maxValue) {
+            throw std::invalid_argument("minValue has to be smaller than maxValue");
+        }
+
+        if (options.threads == 0) {
+            throw std::invalid_argument("At least one thread is required");
+        }
+
+        auto trees = options.parallelism == Parallelism::Root ? options.threads : 1;
+        for (unsigned int i = 0; i < trees; i++) {
+            pools.emplace_back(std::make_unique<MctsNodePool>(std::max<std::size_t>(options.poolCapacity / trees, 1)));
+        }
+    }
+
+    auto Mcts::search(const std::shared_ptr<gameModel::Environment> &env,
+            const std::vector<communication::messages::types::EntityId> &turnOrder,
+            const MctsLimits &limits) -> MctsResult {
+        if (turnOrder.empty() ||
+            !std::all_of(turnOrder.begin(), turnOrder.end(), gameLogic::conversions::isPlayer)) {
+            throw std::invalid_argument("Turn order has to consist of players");
+        }
+
+        const Context context{gameModel::CompactEnvironment(*env), turnOrder,
+                              gameLogic::conversions::idToSide(turnOrder.front())};
+        for (auto &pool : pools) {
+            pool->reset();
+            pool->allocate(1);
+        }
+
+        const auto deadline = std::chrono::steady_clock::now() + limits.budget;
+        std::atomic<std::uint64_t> started{0};
+        std::atomic<std::uint64_t> finished{0};
+        std::vector<std::exception_ptr> errors(options.threads);
+        auto work = [&](unsigned int thread) {
+            try {
+                Xoshiro256 engine(options.seed + thread);
+                ScopedRng scope(engine);
+                std::pmr::monotonic_buffer_resource arena;
+                gameModel::ScopedCloneResource cloneScope(arena);
+                auto scratch = env->clone();
+                auto &pool = *pools[options.parallelism == Parallelism::Root ? thread : 0];
+                while (started.fetch_add(1, std::memory_order_relaxed) < limits.iterations) {
+                    iterate(context, pool, scratch);
+                    finished.fetch_add(1, std::memory_order_relaxed);
+                    if (std::chrono::steady_clock::now() >= deadline) {
+                        break;
+                    }
+                }
+            } catch (...) {
+                errors[thread] = std::current_exception();
+            }
+        };
+
+        std::vector<std::thread> workers;
+        for (unsigned int i = 1; i < options.threads; i++) {
+            workers.emplace_back(work, i);
+        }
+
+        work(0);
+        for (auto &worker : workers) {
+            worker.join();
+        }
+
+        for (const auto &error : errors) {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+
+        // merge the root children of all trees
+        std::vector<std::pair<ActionKey, std::pair<std::uint64_t, double>>> children;
+        MctsResult result;
+        for (const auto &pool : pools) {
+            result.nodes += pool->size();
+            const auto &root = (*pool)[0];
+            if (root.state.load(std::memory_order_acquire) != MctsNode::Expanded) {
+                continue;
+            }
+
+            for (std::uint32_t i = 0; i < root.numberOfChildren.load(std::memory_order_relaxed); i++) {
+                const auto &child = (*pool)[root.firstChild.load(std::memory_order_relaxed) + i];
+                auto it = std::find_if(children.begin(), children.end(), [&child](const auto &entry) {
+                    return entry.first == child.key;
+                });
+                if (it == children.end()) {
+                    children.push_back({child.key, {0, 0}});
+                    it = children.end() - 1;
+                }
+
+                it->second.first += child.visits.load(std::memory_order_relaxed);
+                it->second.second += child.rewardSum.load(std::memory_order_relaxed);
+            }
+        }
+
+        result.iterations = finished.load();
+        auto best = std::max_element(children.begin(), children.end(), [](const auto &a, const auto &b) {
+            return a.second.first < b.second.first;
+        });
+        if (best != children.end() && best->second.first > 0) {
+            result.value = minValue + (maxValue - minValue) * best->second.second / best->second.first;
+            result.bestAction = createAction(env, env->getPlayerById(turnOrder.front()), best->first);
+        }
+
+        return result;
+    }
+
+    void Mcts::iterate(const Context &context, MctsNodePool &pool,
+            const std::shared_ptr<gameModel::Environment> &scratch) const {
+        context.root.applyTo(*scratch);
+        auto getActor = [&context, &scratch](unsigned int ply) {
+            return scratch->getPlayerById(context.turnOrder[ply % context.turnOrder.size()]);
+        };
+
+        auto isMaximizing = [&context](unsigned int ply) {
+            return gameLogic::conversions::idToSide(context.turnOrder[ply % context.turnOrder.size()]) ==
+                   context.rootSide;
+        };
+
+        std::vector<std::uint32_t> path{0};
+        unsigned int ply = 0;
+        while (true) {
+            auto &node = pool[path.back()];
+            auto actor = getActor(ply);
+            std::uint8_t expected = MctsNode::Unexpanded;
+            if (node.state.load(std::memory_order_acquire) == MctsNode::Unexpanded &&
+                node.state.compare_exchange_strong(expected, MctsNode::Expanding, std::memory_order_acq_rel)) {
+                auto keys = generateKeys(scratch, actor);
+                auto first = pool.allocate(static_cast<std::uint32_t>(keys.size()));
+                if (!first.has_value()) {
+                    node.state.store(MctsNode::Unexpanded, std::memory_order_release);
+                    break;
+                }
+
+                for (std::size_t i = 0; i < keys.size(); i++) {
+                    pool[first.value() + static_cast<std::uint32_t>(i)].key = keys[i];
+                }
+
+                node.firstChild.store(first.value(), std::memory_order_relaxed);
+                node.numberOfChildren.store(static_cast<std::uint32_t>(keys.size()), std::memory_order_relaxed);
+                node.state.store(MctsNode::Expanded, std::memory_order_release);
+            }
+
+            if (node.state.load(std::memory_order_acquire) != MctsNode::Expanded) {
+                break;
+            }
+
+            // UCT selection among the children possible in the sampled state, unvisited children first
+            const bool maximizing = isMaximizing(ply);
+            const auto first = node.firstChild.load(std::memory_order_relaxed);
+            const auto count = node.numberOfChildren.load(std::memory_order_relaxed);
+            const double parentVisits = node.visits.load(std::memory_order_relaxed) +
+                                        node.virtualLoss.load(std::memory_order_relaxed) + 1;
+            auto selected = NO_NODE;
+            double bestScore = -std::numeric_limits<double>::infinity();
+            const auto offset = static_cast<std::uint32_t>(rng(0, static_cast<int>(count) - 1));
+            for (std::uint32_t i = 0; i < count; i++) {
+                const auto index = first + (i + offset) % count;
+                auto &child = pool[index];
+                if (!isPossible(scratch, actor, child.key)) {
+                    continue;
+                }
+
+                const auto loss = child.virtualLoss.load(std::memory_order_relaxed);
+                const double visits = child.visits.load(std::memory_order_relaxed) + loss;
+                if (visits == 0) {
+                    selected = index;
+                    break;
+                }
+
+                // virtual loss counts as playouts lost by the selecting team
+                double mean = (child.rewardSum.load(std::memory_order_relaxed) + (maximizing ? 0 : loss)) / visits;
+                if (!maximizing) {
+                    mean = 1 - mean;
+                }
+
+                const double score = mean + options.exploration * std::sqrt(std::log(parentVisits) / visits);
+                if (score > bestScore) {
+                    bestScore = score;
+                    selected = index;
+                }
+            }
+
+            if (selected == NO_NODE) {
+                break;
+            }
+
+            auto &child = pool[selected];
+            const bool unvisited = child.visits.load(std::memory_order_relaxed) == 0;
+            child.virtualLoss.fetch_add(options.virtualLoss, std::memory_order_relaxed);
+            execute(scratch, actor, child.key);
+            path.emplace_back(selected);
+            ply++;
+            if (unvisited) {
+                break;
+            }
+        }
+
+        // random playout
+        for (unsigned int i = 0; i < options.playoutDepth; i++, ply++) {
+            auto actor = getActor(ply);
+            auto keys = generateKeys(scratch, actor);
+            execute(scratch, actor, keys[rng(0, static_cast<int>(keys.size()) - 1)]);
+        }
+
+        const auto value = std::clamp(evaluation(*scratch, context.rootSide), minValue, maxValue);
+        const auto reward = (value - minValue) / (maxValue - minValue);
+        for (std::size_t i = 0; i < path.size(); i++) {
+            auto &node = pool[path[i]];
+            if (i > 0) {
+                node.virtualLoss.fetch_sub(options.virtualLoss, std::memory_order_relaxed);
+            }
+
+            atomicAdd(node.rewardSum, reward);
+            node.visits.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
@@ -0,0 +1,190 @@
+/**
+ * @file Mcts.h
+ * @date
+ * @brief Declaration of a parallel Monte Carlo tree search.
+ */
+
+#ifndef SOPRAGAMELOGIC_MCTS_H
+#define SOPRAGAMELOGIC_MCTS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "GameModel.h"
+#include "Expectimax.h"
+
+namespace gameController {
+
+    /**
+     * Identifies an action of the acting player of a ply independently of the sampled state
+     */
+    struct ActionKey {
+        enum class Kind : std::uint8_t {
+            Pass, ///< the player cannot act
+            Move,
+            Shot,
+            Wrest
+        };
+
+        Kind kind = Kind::Pass;
+        gameModel::Position target{};
+
+        bool operator==(const ActionKey &other) const;
+        bool operator!=(const ActionKey &other) const;
+    };
+
+    /**
+     * Node of the search tree. All members are atomic as the tree is shared between threads with tree parallelism.
+     */
+    struct MctsNode {
+        enum State : std::uint8_t {
+            Unexpanded,
+            Expanding,
+            Expanded
+        };
+
+        std::atomic<std::uint32_t> visits{0};
+        std::atomic<std::uint32_t> virtualLoss{0};
+        std::atomic<double> rewardSum{0}; ///< sum of the rewards for the team of the first actor, each in [0, 1]
+        std::atomic<std::uint32_t> firstChild{0};
+        std::atomic<std::uint32_t> numberOfChildren{0};
+        std::atomic<std::uint8_t> state{Unexpanded};
+        ActionKey key; ///< action leading to this node, written before the node is published
+    };
+
+    /**
+     * Fixed capacity pool the nodes of a tree are allocated from. The children of a node are allocated as one
+     * contiguous block, allocation is lock free. Nodes are never freed individually, the pool is reset as a whole.
+     */
+    class MctsNodePool {
+    public:
+        /**
+         * Constructs a pool
+         * @param capacity maximum number of nodes
+         */
+        explicit MctsNodePool(std::size_t capacity);
+
+        /**
+         * Allocates a block of nodes and resets them
+         * @param count number of nodes
+         * @return index of the first node or nothing if the pool is exhausted
+         */
+        auto allocate(std::uint32_t count) -> std::optional<std::uint32_t>;
+
+        /**
+         * Frees all nodes. Must not be called concurrently with other methods.
+         */
+        void reset();
+
+        auto operator[](std::uint32_t index) -> MctsNode &;
+        auto operator[](std::uint32_t index) const -> const MctsNode &;
+
+        /**
+         * Getter
+         * @return number of allocated nodes
+         */
+        auto size() const -> std::size_t;
+
+        /**
+         * Getter
+         * @return maximum number of nodes
+         */
+        auto capacity() const -> std::size_t;
+
+    private:
+        std::unique_ptr<MctsNode[]> nodes;
+        std::size_t maxNodes;
+        std::atomic<std::size_t> used{0};
+    };
+
+    /**
+     * Limits of a single search. The search stops as soon as one of the limits is reached.
+     */
+    struct MctsLimits {
+        std::uint64_t iterations = 10000;
+        std::chrono::milliseconds budget{1000};
+    };
+
+    /**
+     * Result of a search
+     */
+    struct MctsResult {
+        std::shared_ptr<Action> bestAction; ///< most visited action of the first actor operating on the searched Environment, nullptr if the actor cannot act
+        double value = 0; ///< mean evaluation of the best action for the team of the first actor
+        std::uint64_t iterations = 0; ///< number of played out iterations of all threads
+        std::size_t nodes = 0; ///< number of allocated nodes of all trees
+    };
+
+    /**
+     * Monte Carlo tree search over the actions of a turn order (see Expectimax::search). Actions are taken from
+     * the generators in GameController.h and sampled with Action::execute, so the tree is open loop: a node stands
+     * for a sequence of actions, not for a state. Children whose action is impossible in the sampled state are
+     * skipped during selection. Every iteration ends with a random playout of a fixed number of plies followed by
+     * the evaluation.
+     * With several threads the search either builds one independent tree per thread and merges the statistics of
+     * the root children at the end (root parallelism) or shares one tree between all threads, using virtual loss to
+     * spread the threads over the tree (tree parallelism). The scratch state of every thread is allocated from an
+     * arena of the thread which is released as a whole once the thread is done.
+     */
+    class Mcts {
+    public:
+        enum class Parallelism {
+            Root,
+            Tree
+        };
+
+        /**
+         * Options of the search
+         */
+        struct Options {
+            unsigned int threads = 1;
+            Parallelism parallelism = Parallelism::Tree;
+            double exploration = 1.4; ///< UCT exploration constant
+            unsigned int playoutDepth = 4; ///< number of random plies after the tree
+            std::uint32_t virtualLoss = 3; ///< lost playouts added to a node while a thread is below it
+            std::size_t poolCapacity = 1u << 20u; ///< nodes of all trees together
+            std::uint64_t seed = 0; ///< seed of the engines of the threads
+        };
+
+        /**
+         * main constructor for the Mcts class.
+         * @param evaluation evaluation of the playouts, clamped to [minValue, maxValue]
+         * @param minValue lower bound of all evaluations
+         * @param maxValue upper bound of all evaluations
+         * @param options options of the search
+         * @throws std::invalid_argument if minValue is not smaller than maxValue or there are no threads
+         */
+        Mcts(Evaluation evaluation, double minValue, double maxValue, Options options);
+
+        /**
+         * Searches the best action of the first actor in the given turn order
+         * @param env the state to search, is not modified
+         * @param turnOrder ids of the acting players, one per ply. Plies after the last one start over at the
+         * first one. Banned and knocked out players skip their ply.
+         * @param limits iteration and time limit
+         * @throws std::invalid_argument if turnOrder is empty or contains no player or env contains more than
+         * CompactEnvironment::MAX_CUBES cubes of shit
+         * @return the result of the search
+         */
+        auto search(const std::shared_ptr<gameModel::Environment> &env,
+                const std::vector<communication::messages::types::EntityId> &turnOrder,
+                const MctsLimits &limits = {}) -> MctsResult;
+
+    private:
+        Evaluation evaluation;
+        double minValue;
+        double maxValue;
+        Options options;
+        std::vector<std::unique_ptr<MctsNodePool>> pools;
+
+        struct Context;
+        void iterate(const Context &context, MctsNodePool &pool,
+                const std::shared_ptr<gameModel::Environment> &scratch) const;
+    };
+}
+
+#endif //SOPRAGAMELOGIC_MCTS_H
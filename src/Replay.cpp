@@ -0,0 +1,191 @@
+/**
+ * @file Replay.cpp
+ * @date
+ * @brief Implementation of a seekable binary replay archive of Environments.
+ */
+
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "Replay.h"
+#include "BinarySerialization.h"
+#include "Delta.h"
+
+namespace gameModel {
+
+    namespace {
+        constexpr std::array<std::uint8_t, 2> MAGIC = {'Q', 'R'};
+        constexpr std::size_t HEADER_SIZE = MAGIC.size() + 1;
+        constexpr std::size_t TRAILER_SIZE = 2 * sizeof(std::uint64_t) + sizeof(std::uint32_t) + MAGIC.size();
+    }
+
+    ReplayWriter::ReplayWriter(const std::string &path, std::size_t keyframeInterval) :
+        file(path, std::ios::binary | std::ios::trunc), keyframeInterval(keyframeInterval) {
+        if (keyframeInterval == 0) {
+            throw std::invalid_argument("Keyframe interval has to be positive");
+        }
+
+        if (!file) {
+            throw std::runtime_error("Could not open replay file " + path);
+        }
+
+        BinaryWriter writer(buffer);
+        writer.writeBytes(MAGIC.data(), MAGIC.size());
+        writer.writeByte(REPLAY_FORMAT_VERSION);
+        write(buffer);
+    }
+
+    ReplayWriter::~ReplayWriter() {
+        try {
+            close();
+        } catch (const std::exception &) {
+            // destructors must not throw, call close explicitly to handle errors
+        }
+    }
+
+    void ReplayWriter::append(const Environment &env) {
+        if (closed) {
+            throw std::logic_error("Replay is already closed");
+        }
+
+        buffer.clear();
+        BinaryWriter writer(buffer);
+        if (offsets.size() % keyframeInterval == 0) {
+            writeEnvironment(writer, env, offsets.empty());
+        } else {
+            writeDelta(writer, diff(*previous, env));
+        }
+
+        offsets.emplace_back(size);
+        write(buffer);
+        previous = env.clone();
+    }
+
+    void ReplayWriter::close() {
+        if (closed) {
+            return;
+        }
+
+        closed = true;
+        buffer.clear();
+        BinaryWriter writer(buffer);
+        const auto indexOffset = size;
+        for (auto offset : offsets) {
+            writer.writeUint64(offset);
+        }
+
+        writer.writeUint64(indexOffset);
+        writer.writeUint64(offsets.size());
+        writer.writeUint32(static_cast<std::uint32_t>(keyframeInterval));
+        writer.writeBytes(MAGIC.data(), MAGIC.size());
+        write(buffer);
+        file.close();
+        if (!file) {
+            throw std::runtime_error("Could not write replay file");
+        }
+    }
+
+    auto ReplayWriter::frameCount() const -> std::size_t {
+        return offsets.size();
+    }
+
+    void ReplayWriter::write(const std::vector<std::uint8_t> &data) {
+        file.write(reinterpret_cast<const char *>(data.data()), static_cast<std::streamsize>(data.size()));
+        if (!file) {
+            throw std::runtime_error("Could not write replay file");
+        }
+
+        size += data.size();
+    }
+
+    ReplayReader::ReplayReader(const std::string &path) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("Could not open replay file " + path);
+        }
+
+        struct stat info{};
+        if (fstat(fd, &info) != 0 || static_cast<std::size_t>(info.st_size) < HEADER_SIZE + TRAILER_SIZE) {
+            ::close(fd);
+            throw std::runtime_error("Replay file " + path + " is too small");
+        }
+
+        size = static_cast<std::size_t>(info.st_size);
+        void *mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (mapping == MAP_FAILED) {
+            throw std::runtime_error("Could not map replay file " + path);
+        }
+
+        data = static_cast<const std::uint8_t *>(mapping);
+        try {
+            BinaryReader header(data, HEADER_SIZE);
+            if (!std::equal(MAGIC.begin(), MAGIC.end(), header.readBytes(MAGIC.size())) ||
+                header.readByte() != REPLAY_FORMAT_VERSION) {
+                throw std::runtime_error("File is no replay of a supported version");
+            }
+
+            BinaryReader trailer(data + size - TRAILER_SIZE, TRAILER_SIZE);
+            indexOffset = trailer.readUint64();
+            frames = trailer.readUint64();
+            keyframeInterval = trailer.readUint32();
+            if (!std::equal(MAGIC.begin(), MAGIC.end(), trailer.readBytes(MAGIC.size())) || keyframeInterval == 0 ||
+                indexOffset < HEADER_SIZE || indexOffset > size - TRAILER_SIZE ||
+                frames != (size - TRAILER_SIZE - indexOffset) / sizeof(std::uint64_t) ||
+                (size - TRAILER_SIZE - indexOffset) % sizeof(std::uint64_t) != 0) {
+                throw std::runtime_error("Replay index is corrupt");
+            }
+
+            if (frames > 0) {
+                config = getFrame(0)->config;
+            }
+        } catch (...) {
+            munmap(const_cast<std::uint8_t *>(data), size);
+            throw;
+        }
+    }
+
+    ReplayReader::~ReplayReader() {
+        munmap(const_cast<std::uint8_t *>(data), size);
+    }
+
+    auto ReplayReader::frameCount() const -> std::size_t {
+        return frames;
+    }
+
+    auto ReplayReader::getKeyframeInterval() const -> std::size_t {
+        return keyframeInterval;
+    }
+
+    auto ReplayReader::getFrame(std::size_t frame) const -> std::shared_ptr<Environment> {
+        if (frame >= frames) {
+            throw std::out_of_range("Replay has no frame " + std::to_string(frame));
+        }
+
+        const auto keyframe = frame - frame % keyframeInterval;
+        auto offset = frameOffset(keyframe);
+        BinaryReader keyframeReader(data + offset, indexOffset - offset);
+        auto env = readEnvironment(keyframeReader, config);
+        for (auto i = keyframe + 1; i <= frame; i++) {
+            offset = frameOffset(i);
+            BinaryReader deltaReader(data + offset, indexOffset - offset);
+            apply(*env, readDelta(deltaReader));
+        }
+
+        return env;
+    }
+
+    auto ReplayReader::frameOffset(std::size_t frame) const -> std::uint64_t {
+        BinaryReader reader(data + indexOffset + frame * sizeof(std::uint64_t), sizeof(std::uint64_t));
+        auto offset = reader.readUint64();
+        if (offset < HEADER_SIZE || offset >= indexOffset) {
+            throw std::runtime_error("Replay index is corrupt");
+        }
+
+        return offset;
+    }
+}
@@ -0,0 +1,141 @@
+/**
+ * @file Replay.h
+ * @date
+ * @brief Declaration of a seekable binary replay archive of Environments.
+ */
+
+#ifndef SOPRAGAMELOGIC_REPLAY_H
+#define SOPRAGAMELOGIC_REPLAY_H
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "GameModel.h"
+
+namespace gameModel {
+
+    /**
+     * Current version of the replay format. Layout of version 1, all integers little endian:
+     *  - magic 'Q' 'R', version byte
+     *  - frames: every keyframeInterval-th frame is a keyframe encoded by writeEnvironment (only the first one
+     *    contains the Config), all other frames are encoded by writeDelta relative to the previous frame
+     *  - index: uint64 file offset of every frame
+     *  - trailer: uint64 offset of the index, uint64 number of frames, uint32 keyframe interval, magic 'Q' 'R'
+     */
+    constexpr std::uint8_t REPLAY_FORMAT_VERSION = 1;
+
+    /**
+     * Default number of frames from one keyframe to the next
+     */
+    constexpr std::size_t DEFAULT_KEYFRAME_INTERVAL = 32;
+
+    /**
+     * Appends the states of a match to a replay file
+     */
+    class ReplayWriter {
+    public:
+        /**
+         * main constructor for the ReplayWriter class. Creates or truncates the file.
+         * @param path file to write
+         * @param keyframeInterval number of frames from one keyframe to the next, bounds the work of a seek
+         * @throws std::invalid_argument if keyframeInterval is 0
+         * @throws std::runtime_error if the file can not be opened
+         */
+        explicit ReplayWriter(const std::string &path, std::size_t keyframeInterval = DEFAULT_KEYFRAME_INTERVAL);
+
+        ReplayWriter(const ReplayWriter &) = delete;
+        auto operator=(const ReplayWriter &) -> ReplayWriter & = delete;
+
+        /**
+         * Finishes the file if close has not been called, errors are ignored
+         */
+        ~ReplayWriter();
+
+        /**
+         * Appends the next state of the match. All states have to share the Config of the first one.
+         * @param env the state
+         * @throws std::logic_error if the writer is already closed
+         * @throws std::invalid_argument if an object is not on the field or the teams differ from the previous state
+         * @throws std::runtime_error if writing fails
+         */
+        void append(const Environment &env);
+
+        /**
+         * Writes the index and closes the file. Does nothing if the writer is already closed.
+         * @throws std::runtime_error if writing fails
+         */
+        void close();
+
+        /**
+         * Getter
+         * @return number of frames appended so far
+         */
+        auto frameCount() const -> std::size_t;
+
+    private:
+        std::ofstream file;
+        std::size_t keyframeInterval;
+        std::vector<std::uint64_t> offsets;
+        std::uint64_t size = 0;
+        std::vector<std::uint8_t> buffer;
+        std::shared_ptr<Environment> previous;
+        bool closed = false;
+
+        void write(const std::vector<std::uint8_t> &data);
+    };
+
+    /**
+     * Random access to the frames of a replay file, the file is memory mapped and only the frames needed to
+     * reconstruct a requested one are decoded
+     */
+    class ReplayReader {
+    public:
+        /**
+         * main constructor for the ReplayReader class.
+         * @param path file written by a ReplayWriter
+         * @throws std::runtime_error if the file can not be mapped or is no valid replay
+         */
+        explicit ReplayReader(const std::string &path);
+
+        ReplayReader(const ReplayReader &) = delete;
+        auto operator=(const ReplayReader &) -> ReplayReader & = delete;
+        ~ReplayReader();
+
+        /**
+         * Getter
+         * @return number of frames in the replay
+         */
+        auto frameCount() const -> std::size_t;
+
+        /**
+         * Getter
+         * @return number of frames from one keyframe to the next
+         */
+        auto getKeyframeInterval() const -> std::size_t;
+
+        /**
+         * Reconstructs a frame from the preceding keyframe and the deltas in between
+         * @param frame index of the frame
+         * @throws std::out_of_range if there is no such frame
+         * @throws std::runtime_error if the frame data is malformed
+         * @return new Environment equal to the one appended as frame
+         */
+        auto getFrame(std::size_t frame) const -> std::shared_ptr<Environment>;
+
+    private:
+        const std::uint8_t *data = nullptr;
+        std::size_t size = 0;
+        std::uint64_t indexOffset = 0;
+        std::uint64_t frames = 0;
+        std::size_t keyframeInterval = 0;
+        std::optional<Config> config;
+
+        auto frameOffset(std::size_t frame) const -> std::uint64_t;
+    };
+}
+
+#endif //SOPRAGAMELOGIC_REPLAY_H
@@ -0,0 +1,82 @@
+/**
+ * @file Rng.cpp
+ * @date
+ * @brief Implementation of the random number engine used by the game logic.
+ */
+
+#include <random>
+#include "Rng.h"
+
+namespace gameController {
+
+    namespace {
+        auto splitMix64(std::uint64_t &x) -> std::uint64_t {
+            std::uint64_t z = (x += 0x9E3779B97F4A7C15ull);
+            z = (z ^ (z >> 30u)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27u)) * 0x94D049BB133111EBull;
+            return z ^ (z >> 31u);
+        }
+
+        auto randomSeed() -> std::uint64_t {
+            std::random_device rd;
+            return (static_cast<std::uint64_t>(rd()) << 32u) ^ rd();
+        }
+
+        thread_local Xoshiro256 threadEngine{randomSeed()};
+    }
+
+    Xoshiro256::Xoshiro256() : Xoshiro256(randomSeed()) {}
+
+    Xoshiro256::Xoshiro256(std::uint64_t seed) {
+        this->seed(seed);
+    }
+
+    void Xoshiro256::seed(std::uint64_t seed) {
+        for (auto &s : state) {
+            s = splitMix64(seed);
+        }
+    }
+
+    void Xoshiro256::jump() {
+        constexpr std::array<std::uint64_t, 4> jumpTable{0x180EC6D33CFD0ABAull, 0xD5A61266F0C9392Cull,
+                                                         0xA9582618E03FC9AAull, 0x39ABDC4529B1661Cull};
+        std::array<std::uint64_t, 4> result{};
+        for (auto jump : jumpTable) {
+            for (int bit = 0; bit < 64; bit++) {
+                if (jump & (std::uint64_t{1} << bit)) {
+                    for (std::size_t i = 0; i < result.size(); i++) {
+                        result[i] ^= state[i];
+                    }
+                }
+
+                (*this)();
+            }
+        }
+
+        state = result;
+    }
+
+    bool Xoshiro256::operator==(const Xoshiro256 &other) const {
+        return state == other.state;
+    }
+
+    bool Xoshiro256::operator!=(const Xoshiro256 &other) const {
+        return !(*this == other);
+    }
+
+    auto getThreadRng() -> Xoshiro256 & {
+        return threadEngine;
+    }
+
+    void seedRng(std::uint64_t seed) {
+        getRng().seed(seed);
+    }
+
+    ScopedRng::ScopedRng(Xoshiro256 &engine) : previous(activeRng) {
+        activeRng = &engine;
+    }
+
+    ScopedRng::~ScopedRng() {
+        activeRng = previous;
+    }
+}
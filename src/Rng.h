@@ -0,0 +1,126 @@
+/**
+ * @file Rng.h
+ * @date
+ * @brief Declaration of the random number engine used by the game logic.
+ */
+
+#ifndef SOPRAGAMELOGIC_RNG_H
+#define SOPRAGAMELOGIC_RNG_H
+
+#include <array>
+#include <cstdint>
+#include <limits>
+
+namespace gameController {
+
+    /**
+     * xoshiro256** pseudo random number generator (Blackman, Vigna). Satisfies UniformRandomBitGenerator and
+     * can therefore be used with all std distributions.
+     */
+    class Xoshiro256 {
+    public:
+        using result_type = std::uint64_t;
+
+        /**
+         * Constructs an engine seeded from std::random_device
+         */
+        Xoshiro256();
+
+        /**
+         * Constructs an engine with a fixed seed. Engines constructed with the same seed produce the same sequence.
+         * @param seed the seed, expanded to the full state with splitmix64
+         */
+        explicit Xoshiro256(std::uint64_t seed);
+
+        /**
+         * Resets the state of the engine
+         * @param seed the seed, expanded to the full state with splitmix64
+         */
+        void seed(std::uint64_t seed);
+
+        /**
+         * Advances the engine by 2^128 steps. Can be used to derive non overlapping streams for several workers
+         * from one seed.
+         */
+        void jump();
+
+        /**
+         * Draws the next value. Defined inline as it is called for every random decision.
+         */
+        auto operator()() -> result_type {
+            const auto result = rotl(state[1] * 5, 7) * 9;
+            const auto t = state[1] << 17u;
+            state[2] ^= state[0];
+            state[3] ^= state[1];
+            state[1] ^= state[2];
+            state[0] ^= state[3];
+            state[2] ^= t;
+            state[3] = rotl(state[3], 45);
+            return result;
+        }
+
+        static constexpr auto min() -> result_type {
+            return std::numeric_limits<result_type>::min();
+        }
+
+        static constexpr auto max() -> result_type {
+            return std::numeric_limits<result_type>::max();
+        }
+
+        bool operator==(const Xoshiro256 &other) const;
+        bool operator!=(const Xoshiro256 &other) const;
+
+    private:
+        std::array<std::uint64_t, 4> state{};
+
+        static constexpr auto rotl(std::uint64_t x, int k) -> std::uint64_t {
+            return (x << k) | (x >> (64 - k));
+        }
+    };
+
+    /**
+     * Engine installed with ScopedRng, nullptr if there is none. Only accessed by getRng and ScopedRng.
+     */
+    inline thread_local Xoshiro256 *activeRng = nullptr;
+
+    /**
+     * Gets the engine owned by the calling thread, seeded from std::random_device on first use
+     * @return the engine of the calling thread
+     */
+    auto getThreadRng() -> Xoshiro256 &;
+
+    /**
+     * Gets the engine all random decisions of the game logic (rng, actionTriggered and everything built on top of
+     * them) are drawn from. This is the engine installed with ScopedRng or, if there is none, an engine owned by
+     * the calling thread which is seeded from std::random_device on first use.
+     * @return the active engine of the calling thread
+     */
+    inline auto getRng() -> Xoshiro256 & {
+        return activeRng != nullptr ? *activeRng : getThreadRng();
+    }
+
+    /**
+     * Reseeds the active engine of the calling thread. Used to make matches and tests reproducible.
+     * @param seed the new seed
+     */
+    void seedRng(std::uint64_t seed);
+
+    /**
+     * Installs an engine as the active engine of the calling thread for the lifetime of this object, e.g. an engine
+     * belonging to one match. The previously active engine is restored on destruction. The engine is not owned and
+     * must outlive this object.
+     */
+    class ScopedRng {
+    public:
+        explicit ScopedRng(Xoshiro256 &engine);
+        ~ScopedRng();
+
+        ScopedRng(const ScopedRng &) = delete;
+        auto operator=(const ScopedRng &) -> ScopedRng & = delete;
+
+    private:
+        Xoshiro256 *previous;
+    };
+}
+
+#endif //SOPRAGAMELOGIC_RNG_H
@@ -0,0 +1,109 @@
+/**
+ * @file TranspositionTable.cpp
+ * @date
+ * @brief Implementation of a lock free transposition table for game tree searches.
+ */
+
+#include <cstring>
+#include <stdexcept>
+#include "TranspositionTable.h"
+
+namespace gameController {
+
+    namespace {
+        constexpr unsigned int ACTION_SHIFT = 32;
+        constexpr unsigned int DEPTH_SHIFT = 48;
+        constexpr unsigned int BOUND_SHIFT = 56;
+        constexpr unsigned int GENERATION_SHIFT = 58;
+        constexpr std::uint8_t MAX_GENERATION = 63;
+
+        /**
+         * Packs an entry into 64 bits: value (32 bit float), best action (16), depth (8), bound (2), generation (6).
+         * The generation is never 0, so packed entries are never 0 either.
+         */
+        auto pack(const TranspositionEntry &entry, std::uint8_t generation) -> std::uint64_t {
+            auto value = static_cast<float>(entry.value);
+            std::uint32_t valueBits;
+            std::memcpy(&valueBits, &value, sizeof(valueBits));
+            return static_cast<std::uint64_t>(valueBits) |
+                   static_cast<std::uint64_t>(entry.bestAction) << ACTION_SHIFT |
+                   static_cast<std::uint64_t>(entry.depth) << DEPTH_SHIFT |
+                   static_cast<std::uint64_t>(entry.bound) << BOUND_SHIFT |
+                   static_cast<std::uint64_t>(generation) << GENERATION_SHIFT;
+        }
+
+        auto unpack(std::uint64_t data) -> TranspositionEntry {
+            auto valueBits = static_cast<std::uint32_t>(data);
+            float value;
+            std::memcpy(&value, &valueBits, sizeof(value));
+            TranspositionEntry ret;
+            ret.value = value;
+            ret.bestAction = static_cast<std::uint16_t>(data >> ACTION_SHIFT);
+            ret.depth = static_cast<std::uint8_t>(data >> DEPTH_SHIFT);
+            ret.bound = static_cast<Bound>((data >> BOUND_SHIFT) & 0x3u);
+            return ret;
+        }
+
+        auto getGeneration(std::uint64_t data) -> std::uint8_t {
+            return static_cast<std::uint8_t>(data >> GENERATION_SHIFT);
+        }
+    }
+
+    TranspositionTable::TranspositionTable(std::size_t numberOfEntries) {
+        if(numberOfEntries == 0){
+            throw std::invalid_argument("Transposition table needs at least one entry");
+        }
+
+        std::size_t size = 1;
+        while(size < numberOfEntries){
+            size <<= 1u;
+        }
+
+        slots = std::make_unique<Slot[]>(size);
+        mask = size - 1;
+    }
+
+    auto TranspositionTable::probe(std::uint64_t key) const -> std::optional<TranspositionEntry> {
+        const auto &slot = slots[key & mask];
+        auto data = slot.data.load(std::memory_order_relaxed);
+        auto check = slot.check.load(std::memory_order_relaxed);
+        if(data == 0 || (check ^ data) != key){
+            return std::nullopt;
+        }
+
+        return unpack(data);
+    }
+
+    bool TranspositionTable::store(std::uint64_t key, const TranspositionEntry &entry) {
+        auto &slot = slots[key & mask];
+        const auto currentGeneration = generation.load(std::memory_order_relaxed);
+        const auto oldData = slot.data.load(std::memory_order_relaxed);
+        if(oldData != 0 && getGeneration(oldData) == currentGeneration && unpack(oldData).depth > entry.depth){
+            return false;
+        }
+
+        const auto data = pack(entry, currentGeneration);
+        slot.data.store(data, std::memory_order_relaxed);
+        slot.check.store(key ^ data, std::memory_order_relaxed);
+        return true;
+    }
+
+    void TranspositionTable::newSearch() {
+        auto current = generation.load(std::memory_order_relaxed);
+        std::uint8_t next;
+        do {
+            next = current == MAX_GENERATION ? 1 : static_cast<std::uint8_t>(current + 1);
+        } while(!generation.compare_exchange_weak(current, next, std::memory_order_relaxed));
+    }
+
+    void TranspositionTable::clear() {
+        for(std::size_t i = 0; i <= mask; i++){
+            slots[i].data.store(0, std::memory_order_relaxed);
+            slots[i].check.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    auto TranspositionTable::size() const -> std::size_t {
+        return mask + 1;
+    }
+}
@@ -0,0 +1,96 @@
+/**
+ * @file TranspositionTable.h
+ * @date
+ * @brief Declaration of a lock free transposition table for game tree searches.
+ */
+
+#ifndef SOPRAGAMELOGIC_TRANSPOSITIONTABLE_H
+#define SOPRAGAMELOGIC_TRANSPOSITIONTABLE_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+
+namespace gameController {
+
+    /**
+     * Type of a value stored in the TranspositionTable
+     */
+    enum class Bound : std::uint8_t {
+        Exact, ///< value is the exact (expected) value of the state
+        Lower, ///< value is a lower bound of the value of the state
+        Upper ///< value is an upper bound of the value of the state
+    };
+
+    /**
+     * Search result for a single state
+     */
+    struct TranspositionEntry {
+        static constexpr std::uint16_t NO_ACTION = 0xFFFF;
+
+        double value = 0; ///< stored with single precision
+        Bound bound = Bound::Exact;
+        std::uint8_t depth = 0; ///< remaining search depth the value was calculated with
+        std::uint16_t bestAction = NO_ACTION; ///< index of the best action in the searchers action list
+    };
+
+    /**
+     * Fixed size hash table mapping Zobrist keys (see gameModel::Environment::getHash) to search results.
+     * Entries are replaced by depth: a stored entry is only overwritten by an entry of at least the same depth or by
+     * any entry once a new search has been started with newSearch.
+     * All methods except clear may be called concurrently from multiple threads without locking. Every slot
+     * stores the key xor'ed with the data, so entries torn by concurrent writes are detected and ignored on probe.
+     */
+    class TranspositionTable {
+    public:
+        /**
+         * Constructs an empty table
+         * @param numberOfEntries number of slots, rounded up to the next power of two
+         */
+        explicit TranspositionTable(std::size_t numberOfEntries);
+
+        /**
+         * Looks up a state
+         * @param key Zobrist key of the state
+         * @return the stored entry or nothing if the state is not in the table
+         */
+        auto probe(std::uint64_t key) const -> std::optional<TranspositionEntry>;
+
+        /**
+         * Stores the search result of a state according to the replacement scheme
+         * @param key Zobrist key of the state
+         * @param entry the search result
+         * @return true if the entry was stored, false if a deeper entry of the current search was kept
+         */
+        bool store(std::uint64_t key, const TranspositionEntry &entry);
+
+        /**
+         * Marks all stored entries as outdated. Outdated entries can still be probed but are always replaced.
+         */
+        void newSearch();
+
+        /**
+         * Removes all entries. Must not be called concurrently with other methods.
+         */
+        void clear();
+
+        /**
+         * Getter
+         * @return number of slots
+         */
+        auto size() const -> std::size_t;
+
+    private:
+        struct Slot {
+            std::atomic<std::uint64_t> check{0}; ///< key xor data
+            std::atomic<std::uint64_t> data{0};
+        };
+
+        std::unique_ptr<Slot[]> slots;
+        std::size_t mask;
+        std::atomic<std::uint8_t> generation{1};
+    };
+}
+
+#endif //SOPRAGAMELOGIC_TRANSPOSITIONTABLE_H